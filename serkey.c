@@ -30,12 +30,42 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <linux/serial.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pwd.h>
+#include <grp.h>
+#include <sys/prctl.h>
+#include <sys/mman.h>
+#include <limits.h>
+#include <dirent.h>
+#include <stdarg.h>
+#include <poll.h>
+#include <linux/io_uring.h>
+#include <linux/perf_event.h>
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <sched.h>
+#include <getopt.h>
+#include <linux/audit.h>
+#include <linux/capability.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
 #include <fcntl.h>
 #include <termios.h>
 #include <unistd.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <signal.h>
+#ifdef SERKEY_PROBES
+#include <sys/sdt.h>
+#endif
 
 // Macros *********************************************************************
 // I've never liked how the static keyword is overloaded in C
@@ -48,9 +78,78 @@
 	   fprintf(stdout,fmt_str, ##__VA_ARGS__); \
 }while(0)
 
+// USDT probes for bpftrace and perf, compiled out when built without them
+#ifdef SERKEY_PROBES
+#define PROBE(name,...)    STAP_PROBEV(serkey, name, ##__VA_ARGS__)
+#else
+#define PROBE(name,...)    do{}while(0)
+#endif
+
 // Constants ******************************************************************
 #define KEYMAPS      4
 #define KEYS_PER_MAP 256
+#define EVENTS_PER_WAIT    8     // Max epoll events handled per loop
+#define SERIAL_READ_SIZE   64    // Max bytes read from the serial port at once
+#define SERIAL_TX_QUEUE    256   // Size of the queue of bytes sent to the keyboard
+#define FEEDBACK_NONE      -1    // No byte is sent for the feedback event
+#define TIMER_TICK_MS      1000  // Event loop timer period in milliseconds
+#define CONFIG_FILE        "/etc/serkey.conf"   // Default configuration file
+#define CONFIG_FILE_SIZE   4096  // Max size of the configuration file
+#define OPTION_DEVICE      256   // Serial device option, no short switch
+#define OPTION_DUMP_KEYMAP 257   // Dump the key map option, no short switch
+#define OPTION_CHECK_KEYMAP 258  // Check the key maps option, no short switch
+#define OPTION_PROFILE     259   // Profile option, no short switch
+#define OPTION_SELFTEST    260   // Self-test option, no short switch
+#define CHECK_KEYS         2000000  // Keys sent through the pipeline to measure throughput
+#define SELFTEST_KEYS      2000  // Keys sent through the virtual keyboard by the self-test
+#define SELFTEST_BATCH     4     // Keys per read, their events fit the event device's buffer
+#define SELFTEST_EVENTS    64    // Max events expected from one write
+#define SELFTEST_SAMPLES   16384 // Max write to readable latencies measured
+#define SELFTEST_TIMEOUT_MS 1000 // Max wait for the event device or its events
+#define SELFTEST_RETRY_MS  10    // Wait between looking for the event device
+#define OUTPUT_PENDING     1024  // Events queued while the output isn't accepting them
+#define OUTPUT_DRAIN_MS    100   // Max milliseconds to wait for the output on exit
+#define BUS_DEVICES        32    // Max keypads on a multi-drop bus
+#define FRAME_DLE          0x10  // Frame escape, DLE STX starts and DLE ETX ends a frame
+#define FRAME_STX          0x02
+#define FRAME_ETX          0x03
+#define OUTPUT_HIGH_WATER  (OUTPUT_PENDING * 3 / 4)   // Pending events that deassert RTS
+#define OUTPUT_LOW_WATER   (OUTPUT_PENDING / 4)       // Pending events that reassert RTS
+#define OPTIONS_MAX        48    // Max entries in the option table
+#define FRAME_EVENTS       256   // Max events batched into a single write
+#define URING_ENTRIES      64    // io_uring submission queue entries
+#define URING_WRITE_EVENTS (4 * FRAME_EVENTS)   // Events queued while an io_uring write is in flight
+#define URING_STASH        256   // Completions deferred while waiting for a write
+#define KEY_QUEUE_SIZE     4096  // Records in the reader to emitter queue, power of 2
+#define CACHE_LINE         64    // Bytes per cache line
+#define DEBOUNCE_MAX_MS    1000  // Max debounce window in milliseconds
+#define RATE_LIMIT_MAX     100000   // Max keys per second rate limit
+#define QUARANTINE_MIN_MS  1000  // First quarantine of a keypad in milliseconds
+#define QUARANTINE_MAX_MS  64000 // Longest quarantine, doubled from QUARANTINE_MIN_MS
+#define REPEAT_DELAY_MAX_MS 10000   // Max autorepeat delay in milliseconds
+#define REPEAT_RATE_MAX    100   // Max autorepeats per second
+#define REPEAT_RATE        30    // Default autorepeats per second
+#define NS_PER_SEC         1000000000ULL
+#define HANDOFF_MAGIC      0x534b4802  // Handoff message "SKH" version 2
+#define HANDOFF_TIMEOUT_MS 5000  // Max wait for the other serkey during a handoff
+#define STATS_MAGIC        0x534b5350  // Stats page "SKSP"
+#define STATS_VERSION      2     // Changes when the stats page layout does
+#define STATS_LATENCY_BUCKETS 20 // Latency buckets, the last counts 2^18 microseconds and over
+#define METRICS_SIZE       16384 // Max bytes of formatted metrics
+#define PROFILE_COUNTERS   4     // Max perf_event counters read together
+#define PROFILE_BUCKETS    40    // Per key count buckets, the last counts 2^38 and over
+#define PROFILE_CALIBRATE  16    // Back to back reads measuring the counters' own cost
+
+// Architecture checked by the seccomp filter
+#if defined(__x86_64__)
+#define SECCOMP_ARCH AUDIT_ARCH_X86_64
+#elif defined(__i386__)
+#define SECCOMP_ARCH AUDIT_ARCH_I386
+#elif defined(__aarch64__)
+#define SECCOMP_ARCH AUDIT_ARCH_AARCH64
+#elif defined(__arm__)
+#define SECCOMP_ARCH AUDIT_ARCH_ARM
+#endif
 
 // Data Types *****************************************************************
 // Keymap
@@ -64,8 +163,9 @@ typedef enum
 
 typedef struct
 {
-    char key;
+    uint16_t key;
     bool control,shift,makebreak;
+    bool make;    // Without makebreak, send a make instead of a break
 }keymap_t;
 
 // Serial Port
@@ -96,6 +196,322 @@ typedef struct
    speed_t  speed;
 }baudrate_t;
 
+// Named value of an option
+typedef struct
+{
+   char     *name;                           // Value as written on the command line
+   int      value;                           // Value stored in the configuration
+}optionvalue_t;
+
+// Command line option and configuration file setting
+typedef struct
+{
+   char                 *name;               // Long option and configuration file setting name
+   int                  option;              // Short option character or OPTION_DEVICE
+   bool                 value;               // Takes a value, otherwise on/off
+   bool                 config;              // Allowed in the configuration file
+   const optionvalue_t  *values;             // Valid values terminated by a NULL name, or NULL
+   char                 *error;              // Description of an invalid value
+   int                  code;                // Return code for an invalid value
+}option_t;
+
+// Serial errors (parity, framing, and break marked in-band with PARMRK)
+typedef enum
+{
+   ERRORS_IGNORE,    // Errors are not marked, bytes are mapped as received
+   ERRORS_COUNT,     // Errors are marked and counted, bytes are still mapped
+   ERRORS_DROP       // Errors are marked and counted, bytes are dropped
+}errors_t;
+
+typedef enum
+{
+   MARK_IDLE,        // No mark sequence in progress
+   MARK_FF,          // Received \377
+   MARK_FF00         // Received \377 \0
+}markstate_t;
+
+// Multi-drop bus frame, DLE STX <address> <key>... DLE ETX. A DLE in the
+// address or keys is sent as DLE DLE
+typedef enum
+{
+   FRAME_IDLE,       // Waiting for DLE STX
+   FRAME_IDLE_DLE,   // Received DLE between frames
+   FRAME_ADDRESS,    // Waiting for the address
+   FRAME_ADDRESS_DLE,// Received DLE in place of the address
+   FRAME_KEYS,       // Receiving keys
+   FRAME_KEYS_DLE    // Received DLE in the keys
+}framestate_t;
+
+// State handed from a running serkey to the one replacing it, along with
+// the serial port and output file descriptors
+typedef struct
+{
+   uint32_t       magic;         // HANDOFF_MAGIC
+   int            output;        // Output of the file descriptor, must match
+   int32_t        pid;           // Process ID of the new serkey, systemd's MAINPID
+   int            watchdogMs;    // systemd watchdog period, 0 if not enabled
+   struct termios ttyConfig;     // Serial configuration to restore at exit
+   uint8_t        heldKeys[KEY_CNT / 8];
+   framestate_t   frameState;    // Bus frame being received
+   int            frameAddress;  // Address of the bus frame, -1 if unknown
+}handoff_t;
+
+// Keypad on the serial port or on a multi-drop bus
+typedef struct
+{
+   keymap_t       *map;                      // Key map of the keypad
+   int            address;                   // Bus address
+   uint64_t       lastSeen[KEYS_PER_MAP];    // CLOCK_MONOTONIC nanoseconds each byte was last accepted
+   uint64_t       nextKey;       // Time the next key is due under the rate limit
+   uint64_t       windowStart;   // Start of the one second window bad bytes are counted in
+   unsigned long  windowBad;     // Unmapped and rate limited bytes in the window
+   uint64_t       quarantineEnd; // Time the last quarantine ends or ended
+   uint64_t       backoffNs;     // Length of the last quarantine
+   unsigned long  keys;          // Keys accepted
+   unsigned long  limited;       // Keys dropped by the rate limit
+   unsigned long  unmapped;      // Keys without a key in the key map
+   unsigned long  quarantined;   // Bytes dropped while quarantined
+   unsigned long  quarantines;   // Times quarantined
+   uint64_t       *keyCounts;    // Bytes received by value, written only by the event loop. In the stats page if published
+}device_t;
+
+// Statistics page shared with monitors. The counters are updated under a
+// seqlock, the sequence is odd while they change. The latency buckets and
+// key counts are updated as keys arrive, each is a single atomic store
+typedef struct
+{
+   uint32_t       magic;         // STATS_MAGIC
+   uint32_t       version;       // STATS_VERSION
+   uint32_t       sequence;      // Incremented before and after the counters are updated
+   int32_t        pid;           // Process updating the page, 0 once it has exited
+   uint64_t       updated;       // CLOCK_MONOTONIC nanoseconds of the last update
+   uint64_t       keys, marked, dropped, breaks, suppressed, waits;
+   uint64_t       feedbackDropped;
+   uint64_t       frames, frameErrors, unknownAddress;
+   uint64_t       outputStalls, outputStallMaxNs, outputStallTotalNs;
+   uint64_t       outputPendingHighWater, outputDropped, throttles;
+   uint64_t       queueHighWater, queueDelayMaxNs;
+   uint64_t       rx, overrun, bufOverrun, parity, frame, brk;
+   uint64_t       latency[STATS_LATENCY_BUCKETS];   // Keys by read to write latency, bucket i under 2^i microseconds
+   int32_t        keypads;       // Rows of keyCounts in use, the serial port's keypad and the bus keypads
+   int32_t        addresses[BUS_DEVICES + 1];                 // Bus address of the keypad counted in each row
+   uint64_t       keyCounts[BUS_DEVICES + 1][KEYS_PER_MAP];   // Bytes received by value by each keypad, row 0 is an unframed serial port's
+}statspage_t;
+
+// Statistics
+typedef struct
+{
+   unsigned long                 keys;       // Bytes received from the serial port
+   unsigned long                 marked;     // Bytes marked with a parity or framing error
+   unsigned long                 dropped;    // Marked bytes dropped
+   unsigned long                 breaks;     // Break conditions marked in-band
+   unsigned long                 waits;      // epoll_wait or io_uring_enter calls
+   uint64_t                      queueDelayMax; // Max nanoseconds a key waited in the queue
+   unsigned long                 suppressed; // Repeated bytes dropped by the debounce filter
+   unsigned long                 throttles;  // Times RTS was deasserted because the output was behind
+   unsigned long                 frames;     // Bus frames received
+   unsigned long                 frameErrors;   // Bytes outside a frame or invalid escapes
+   unsigned long                 unknownAddress;   // Bus frames from an address without a keypad
+   unsigned long                 repeats;    // Autorepeats of held keys
+   bool                          icountValid;// Driver supports TIOCGICOUNT
+   struct serial_icounter_struct icount;     // Driver counters from TIOCGICOUNT
+}stats_t;
+
+// Autorepeat of the last key made
+typedef struct
+{
+   int            key;                       // Key repeating, KEY_RESERVED if none
+   uint64_t       next;                      // CLOCK_MONOTONIC nanoseconds of the next repeat, 0 until scheduled
+   uint64_t       tick;                      // CLOCK_MONOTONIC nanoseconds of the next timer tick
+   uint64_t       tickNs;                    // Timer tick period
+}repeat_t;
+
+// Keyboard feedback (LED and bell state sent back to the keyboard)
+typedef enum
+{
+   FEEDBACK_CAPS_ON,
+   FEEDBACK_CAPS_OFF,
+   FEEDBACK_BELL,
+   FEEDBACK_CLICK,
+   FEEDBACKS
+}feedbacks_t;
+
+typedef struct
+{
+   unsigned char  data[SERIAL_TX_QUEUE];
+   unsigned int   head, tail;
+   unsigned long  dropped;
+   bool           blocked;
+}txqueue_t;
+
+// Metrics exporter
+typedef enum
+{
+   METRICS_NONE,     // Not exported
+   METRICS_SOCKET,   // Served to each connection to a Unix socket
+   METRICS_FILE      // Written to a file once a second for a textfile collector
+}metrics_t;
+
+typedef struct
+{
+   char           data[METRICS_SIZE];
+   size_t         length;
+}metricsbuffer_t;
+
+// Profiling counters
+typedef struct
+{
+   const char     *name;                     // Name displayed
+   uint32_t       type;                      // PERF_TYPE_HARDWARE or PERF_TYPE_SOFTWARE
+   uint64_t       config;                    // PERF_COUNT_*
+}profilecounter_t;
+
+typedef struct
+{
+   int            fd;                        // Group leader, -1 if not profiling
+   int            count;                     // Counters in the group
+   const profilecounter_t *counters[PROFILE_COUNTERS];   // In the order the group is read
+   bool           software;                  // No PMU, task-clock replaces cycles
+   bool           userOnly;                  // Counting the kernel isn't permitted
+   uint64_t       start[PROFILE_COUNTERS];   // Counts when the batch started
+   uint64_t       overhead[PROFILE_COUNTERS];   // Counted by reading the counters
+   uint64_t       total[PROFILE_COUNTERS];
+   uint64_t       max[PROFILE_COUNTERS];     // Most per key in a batch
+   uint64_t       buckets[PROFILE_COUNTERS][PROFILE_BUCKETS];  // Keys by count per key, bucket i under 2^i
+   unsigned long  keys, batches;
+}profile_t;
+
+// Self-test of the virtual keyboard
+typedef struct
+{
+   int                  fd;                  // Event device of the virtual keyboard, -1 if not open
+   uint8_t              keybits[KEY_CNT / 8];   // Keys registered with the input core
+   uint8_t              pressed[KEY_CNT / 8];   // Keys the input core has made
+   struct input_event   packet[SELFTEST_EVENTS];   // Events passed on at the next SYN_REPORT
+   size_t               packetCount;
+   struct input_event   expected[SELFTEST_EVENTS]; // Events passed on and not read back yet
+   size_t               expectedCount;
+   unsigned long        events, received, unexpected, missing, dropped;
+   uint64_t             latency[SELFTEST_SAMPLES]; // Nanoseconds from a write to the event device being readable
+   size_t               samples;
+}selftest_t;
+
+// Output backends
+typedef enum
+{
+   OUTPUT_UINPUT,    // uinput virtual keyboard
+   OUTPUT_STDOUT,    // Binary input_event stream to stdout
+   OUTPUT_FILE,      // Binary input_event stream to a file
+   OUTPUT_SOCKET,    // Binary input_event stream to a Unix socket
+   OUTPUTS
+}outputs_t;
+
+typedef struct
+{
+   char     *name;                           // Command line name
+   bool     path;                            // Requires a path
+   bool     feedback;                        // Returns LED and sound events
+   int      (*connect)(char *path);          // Open the output, returns the fd
+   ssize_t  (*write)(int fd,                 // Write events to the output, returns bytes written
+                     const void *data,
+                     size_t size);
+   void     (*disconnect)(int fd);           // Remove and close the output
+}output_t;
+
+// Event loop
+typedef enum
+{
+   LOOP_EPOLL,       // epoll_wait and read/write system calls
+   LOOP_URING        // io_uring linked reads and batched write submissions
+}loop_t;
+
+// Output pending queue overflow policy
+typedef enum
+{
+   OVERFLOW_DROP,    // Drop the new events, releasing their keys once drained
+   OVERFLOW_EXIT     // Exit so the service manager restarts serkey
+}overflow_t;
+
+// Events waiting for the output to accept them
+typedef struct
+{
+   unsigned char  data[OUTPUT_PENDING * sizeof(struct input_event)];
+   size_t         start;                     // Bytes written
+   size_t         end;                       // Bytes queued
+   size_t         highWater;                 // Max bytes queued
+   uint64_t       stallStart;                // CLOCK_MONOTONIC nanoseconds the output stopped accepting
+   uint64_t       stallMax;                  // Longest stall in nanoseconds
+   uint64_t       stallTotal;                // Nanoseconds stalled
+   unsigned long  stalls;                    // Times the output stopped accepting
+   unsigned long  dropped;                   // Events dropped when the queue was full
+   bool           lost;                      // Releases were dropped
+   uint8_t        lostReleases[KEY_CNT / 8 + 1];   // Keys whose release was dropped
+}pending_t;
+
+// Per-key count format
+typedef enum
+{
+   COUNTS_CSV,
+   COUNTS_JSON
+}counts_t;
+
+typedef enum
+{
+   URING_POLL = 1,   // Poll linked ahead of a serial read
+   URING_READ,       // Serial read into the registered buffer
+   URING_WRITE,      // Output write
+   URING_WATCH,      // Multishot poll of the timer, signals, or output
+   URING_POLLOUT,    // Serial port writable
+   URING_CANCEL      // Cancel of the serial read before a handoff
+}uringop_t;
+
+typedef struct
+{
+   uint64_t             user_data;           // Operation tag and file descriptor
+   int32_t              res;                 // Result of the operation
+   uint32_t             flags;               // IORING_CQE_F_*
+}uringcqe_t;
+
+typedef struct
+{
+   int                  fd;                  // io_uring file descriptor or -1
+   unsigned             *sqHead, *sqTail, *sqMask, *sqArray, sqEntries;
+   unsigned             *cqHead, *cqTail, *cqMask;
+   struct io_uring_sqe  *sqes;
+   struct io_uring_cqe  *cqes;
+   unsigned             queued;              // Entries queued since the last submit
+   uringcqe_t           stash[URING_STASH];  // Completions deferred while waiting for a write
+   unsigned             stashHead, stashTail;
+   struct input_event   writes[2][URING_WRITE_EVENTS];   // In flight and next write
+   size_t               writeCount[2];
+   int                  writeNext;           // Index of the write being filled
+   bool                 writing;             // A write is in flight
+   size_t               writeOffset;         // Bytes of the write in flight already written
+   uint8_t              writeOp;             // IORING_OP_WRITE or IORING_OP_SEND
+}uring_t;
+
+// Reader thread to emitter queue
+typedef struct
+{
+   uint64_t             time;                // CLOCK_MONOTONIC nanoseconds when read
+   unsigned char        key;                 // Byte read from the serial port
+}keyrecord_t;
+
+typedef struct
+{
+   // Each index is written by one thread and kept on its own cache line
+   _Alignas(CACHE_LINE) unsigned head;       // Next record written by the reader
+   _Alignas(CACHE_LINE) unsigned tail;       // Next record read by the emitter
+   _Alignas(CACHE_LINE) unsigned highWater;  // Max records queued, written by the reader
+   bool                 readerWaiting;       // Reader is waiting for space
+   int                  readerErrno;         // Reader stopped, errno or 0 for end of file
+   bool                 readerStopped;
+   int                  dataFd;              // eventfd signaled when records are queued
+   int                  spaceFd;             // eventfd signaled when space is freed
+   int                  stopFd;              // eventfd signaled to stop the reader for a handoff
+   _Alignas(CACHE_LINE) keyrecord_t records[KEY_QUEUE_SIZE];
+}keyqueue_t;
+
 // Configuration
 typedef struct CONFIG
 {
@@ -105,13 +521,47 @@ typedef struct CONFIG
    stopbits_t   stopbits;
    keymaps_t   keymap;
    char        *tty;
-   bool        fork, verbose;
+   errors_t    errors;
+   outputs_t   output;
+   char        *outputPath;
+   char        *user;
+   char        *upgradePath;  // Socket to hand off to a new serkey, NULL if off
+   char        *statsPath;    // Stats page published for monitors, NULL if off
+   metrics_t   metrics;
+   char        *metricsPath;
+   bool        seccomp;
+   bool        profile;
+   bool        batch;
+   int         rtPriority;
+   loop_t      loop;
+   bool        threads;
+   bool        flowControl;
+   counts_t    counts;
+   uint64_t    debounceNs;
+   uint64_t    rateIntervalNs;   // Time between keys at the rate limit, 0 if not limited
+   uint64_t    rateBurstNs;      // Time the keys allowed in a burst are ahead of the rate
+   unsigned long quarantineBytes;   // Bad bytes per second that quarantine a keypad, 0 if never
+   uint64_t    repeatDelayNs;    // Time a key is held before it repeats, 0 if not repeated
+   uint64_t    repeatPeriodNs;   // Time between repeats
+   const char  *remap;
+   overflow_t  overflow;
+   bool        dumpKeymap;
+   bool        checkKeymap;
+   bool        selftest;
+   bool        fork, verbose, feedback;
+   int         feedbackBytes[FEEDBACKS];
 }config_t;
 
 // Globals ********************************************************
 // Serial Port 
 struct termios ttyConfig;
 int            ttyFd = 0;
+
+// Output
+int            outputFd = -1;
+unsigned int   outputEvents = 0;          // epoll events the output is watched for, 0 if not watched
+pending_t      pending;
+local uint8_t  heldKeys[KEY_CNT / 8];     // Bit set for each key currently made
 baudrate_t     speeds[] =
 {
    {.baudrate = 50, .speed = B50},
@@ -131,6 +581,199 @@ baudrate_t     speeds[] =
    {.baudrate = 1152000, .speed = B1152000}
 };
 
+// Event loop
+int            epollFd = -1;
+uring_t        uring = {.fd = -1};
+keyqueue_t     keyQueue = {.dataFd = -1, .spaceFd = -1, .stopFd = -1};
+pthread_t      readerThread;
+int            upgradeFd = -1;            // Socket listening for a new serkey to hand off to
+int            upgradeClientFd = -1;      // New serkey connected, waiting for its request
+unsigned int   serialEvents = EPOLLIN;    // Serial events the event loop reads, 0 if the reader thread does
+local unsigned char uringBuffer[SERIAL_READ_SIZE];    // Registered serial read buffer
+int            timerFd = -1;
+repeat_t       repeat = {.key = KEY_RESERVED};
+int            signalFd = -1;
+int            notifyFd = -1;
+int            watchdogMs = 0;
+txqueue_t      txQueue;
+markstate_t    markState = MARK_IDLE;
+stats_t        stats;
+local uint64_t keyCountBuffer[BUS_DEVICES + 1][KEYS_PER_MAP];   // Each keypad's byte counts until the stats page is created
+statspage_t    *statsPage = NULL;
+local uint64_t latencyBuffer[STATS_LATENCY_BUCKETS];
+uint64_t       *latency = latencyBuffer;  // Keys by read to write latency, bucket i under 2^i microseconds. In the stats page if published
+uint64_t       latencySum;                // Nanoseconds of latency of the keys counted
+bool           measureLatency = false;    // Stats page or metrics enabled
+int            metricsFd = -1;            // Socket listening for metrics scrapes
+int            metricsDirFd = -1;         // Directory of the metrics file
+local char     *metricsName;              // Metrics file in metricsDirFd
+local char     metricsTemp[NAME_MAX + 1]; // File in metricsDirFd the metrics are written to before renaming
+local bool     metricsFailed = false;     // The last metrics file write failed
+local metricsbuffer_t metricsBuffer;
+profile_t      profile = {.fd = -1};
+keymap_t       activeMap[KEYS_PER_MAP];   // Selected key map with the remap rules applied
+device_t       devices[BUS_DEVICES + 1] = {{.map = activeMap}};   // [0] is the keypad of an unframed serial port
+uint8_t        deviceOf[256];             // Index in devices of each bus address, 0 if not on the bus
+int            busDevices;                // Keypads on the bus, 0 if the serial port isn't framed
+framestate_t   frameState;
+device_t       *frameDevice;              // Keypad that sent the frame, NULL if unknown
+
+// Option values
+local const optionvalue_t parityValues[] =
+{
+   {.name = "none", .value = PARITY_NONE},
+   {.name = "even", .value = PARITY_EVEN},
+   {.name = "odd", .value = PARITY_ODD},
+   {.name = NULL}
+};
+
+local const optionvalue_t databitsValues[] =
+{
+   {.name = "5", .value = DATABITS_5},
+   {.name = "6", .value = DATABITS_6},
+   {.name = "7", .value = DATABITS_7},
+   {.name = "8", .value = DATABITS_8},
+   {.name = NULL}
+};
+
+local const optionvalue_t stopbitsValues[] =
+{
+   {.name = "1", .value = STOPBITS_1},
+   {.name = "2", .value = STOPBITS_2},
+   {.name = NULL}
+};
+
+local const optionvalue_t keymapValues[] =
+{
+   {.name = "kaypro", .value = KEYMAP_KAYPRO},
+   {.name = "ascii", .value = KEYMAP_ASCII},
+   {.name = "media_keys", .value = KEYMAP_MEDIA_KEYS},
+   {.name = NULL}
+};
+
+local const optionvalue_t loopValues[] =
+{
+   {.name = "epoll", .value = LOOP_EPOLL},
+   {.name = "uring", .value = LOOP_URING},
+   {.name = NULL}
+};
+
+local const optionvalue_t countsValues[] =
+{
+   {.name = "csv", .value = COUNTS_CSV},
+   {.name = "json", .value = COUNTS_JSON},
+   {.name = NULL}
+};
+
+local const optionvalue_t overflowValues[] =
+{
+   {.name = "drop", .value = OVERFLOW_DROP},
+   {.name = "exit", .value = OVERFLOW_EXIT},
+   {.name = NULL}
+};
+
+local const optionvalue_t errorsValues[] =
+{
+   {.name = "ignore", .value = ERRORS_IGNORE},
+   {.name = "count", .value = ERRORS_COUNT},
+   {.name = "drop", .value = ERRORS_DROP},
+   {.name = NULL}
+};
+
+// Key names accepted by the remap rules, any other key is given by its code
+#define KEY_NAME(key)   {.name = #key, .value = key}
+local const optionvalue_t keyNames[] =
+{
+   KEY_NAME(KEY_RESERVED), KEY_NAME(KEY_ESC), KEY_NAME(KEY_1), KEY_NAME(KEY_2),
+   KEY_NAME(KEY_3), KEY_NAME(KEY_4), KEY_NAME(KEY_5), KEY_NAME(KEY_6),
+   KEY_NAME(KEY_7), KEY_NAME(KEY_8), KEY_NAME(KEY_9), KEY_NAME(KEY_0),
+   KEY_NAME(KEY_MINUS), KEY_NAME(KEY_EQUAL), KEY_NAME(KEY_BACKSPACE), KEY_NAME(KEY_TAB),
+   KEY_NAME(KEY_Q), KEY_NAME(KEY_W), KEY_NAME(KEY_E), KEY_NAME(KEY_R),
+   KEY_NAME(KEY_T), KEY_NAME(KEY_Y), KEY_NAME(KEY_U), KEY_NAME(KEY_I),
+   KEY_NAME(KEY_O), KEY_NAME(KEY_P), KEY_NAME(KEY_LEFTBRACE), KEY_NAME(KEY_RIGHTBRACE),
+   KEY_NAME(KEY_ENTER), KEY_NAME(KEY_LEFTCTRL), KEY_NAME(KEY_A), KEY_NAME(KEY_S),
+   KEY_NAME(KEY_D), KEY_NAME(KEY_F), KEY_NAME(KEY_G), KEY_NAME(KEY_H),
+   KEY_NAME(KEY_J), KEY_NAME(KEY_K), KEY_NAME(KEY_L), KEY_NAME(KEY_SEMICOLON),
+   KEY_NAME(KEY_APOSTROPHE), KEY_NAME(KEY_GRAVE), KEY_NAME(KEY_LEFTSHIFT), KEY_NAME(KEY_BACKSLASH),
+   KEY_NAME(KEY_Z), KEY_NAME(KEY_X), KEY_NAME(KEY_C), KEY_NAME(KEY_V),
+   KEY_NAME(KEY_B), KEY_NAME(KEY_N), KEY_NAME(KEY_M), KEY_NAME(KEY_COMMA),
+   KEY_NAME(KEY_DOT), KEY_NAME(KEY_SLASH), KEY_NAME(KEY_RIGHTSHIFT), KEY_NAME(KEY_KPASTERISK),
+   KEY_NAME(KEY_LEFTALT), KEY_NAME(KEY_SPACE), KEY_NAME(KEY_CAPSLOCK), KEY_NAME(KEY_F1),
+   KEY_NAME(KEY_F2), KEY_NAME(KEY_F3), KEY_NAME(KEY_F4), KEY_NAME(KEY_F5),
+   KEY_NAME(KEY_F6), KEY_NAME(KEY_F7), KEY_NAME(KEY_F8), KEY_NAME(KEY_F9),
+   KEY_NAME(KEY_F10), KEY_NAME(KEY_NUMLOCK), KEY_NAME(KEY_SCROLLLOCK), KEY_NAME(KEY_KP7),
+   KEY_NAME(KEY_KP8), KEY_NAME(KEY_KP9), KEY_NAME(KEY_KPMINUS), KEY_NAME(KEY_KP4),
+   KEY_NAME(KEY_KP5), KEY_NAME(KEY_KP6), KEY_NAME(KEY_KPPLUS), KEY_NAME(KEY_KP1),
+   KEY_NAME(KEY_KP2), KEY_NAME(KEY_KP3), KEY_NAME(KEY_KP0), KEY_NAME(KEY_KPDOT),
+   KEY_NAME(KEY_F11), KEY_NAME(KEY_F12), KEY_NAME(KEY_KPENTER), KEY_NAME(KEY_RIGHTCTRL),
+   KEY_NAME(KEY_KPSLASH), KEY_NAME(KEY_SYSRQ), KEY_NAME(KEY_RIGHTALT), KEY_NAME(KEY_LINEFEED),
+   KEY_NAME(KEY_HOME), KEY_NAME(KEY_UP), KEY_NAME(KEY_PAGEUP), KEY_NAME(KEY_LEFT),
+   KEY_NAME(KEY_RIGHT), KEY_NAME(KEY_END), KEY_NAME(KEY_DOWN), KEY_NAME(KEY_PAGEDOWN),
+   KEY_NAME(KEY_INSERT), KEY_NAME(KEY_DELETE), KEY_NAME(KEY_MUTE), KEY_NAME(KEY_VOLUMEDOWN),
+   KEY_NAME(KEY_VOLUMEUP), KEY_NAME(KEY_POWER), KEY_NAME(KEY_PAUSE), KEY_NAME(KEY_LEFTMETA),
+   KEY_NAME(KEY_RIGHTMETA), KEY_NAME(KEY_COMPOSE), KEY_NAME(KEY_STOP), KEY_NAME(KEY_CANCEL),
+   KEY_NAME(KEY_HELP), KEY_NAME(KEY_MENU), KEY_NAME(KEY_NEXTSONG), KEY_NAME(KEY_PLAYPAUSE),
+   KEY_NAME(KEY_PREVIOUSSONG), KEY_NAME(KEY_STOPCD), KEY_NAME(KEY_EJECTCLOSECD), KEY_NAME(KEY_PRINT),
+   {.name = NULL}
+};
+
+// Command line options and configuration file settings
+local const option_t options[] =
+{
+   {.name = "device", .option = OPTION_DEVICE, .value = true, .config = true},
+   {.name = "baud", .option = 'b', .value = true, .config = true, .error = "Invalid Baudrate", .code = -4},
+   {.name = "parity", .option = 'p', .value = true, .config = true, .values = parityValues, .error = "Invalid parity", .code = -5},
+   {.name = "data_bits", .option = 'd', .value = true, .config = true, .values = databitsValues, .error = "Invalid data bits", .code = -6},
+   {.name = "stop_bits", .option = 's', .value = true, .config = true, .values = stopbitsValues, .error = "Invalid stop bits", .code = -7},
+   {.name = "key_map", .option = 'k', .value = true, .config = true, .values = keymapValues, .error = "Invalid key map", .code = -8},
+   {.name = "errors", .option = 'e', .value = true, .config = true, .values = errorsValues, .error = "Invalid serial error handling", .code = -13},
+   {.name = "feedback", .option = 'l', .value = true, .config = true, .error = "Invalid feedback bytes", .code = -10},
+   {.name = "output", .option = 'o', .value = true, .config = true, .error = "Invalid output", .code = -14},
+   {.name = "bus", .option = 'a', .value = true, .config = true, .error = "Invalid bus addresses", .code = -39},
+   {.name = "remap", .option = 'm', .value = true, .config = true},
+   {.name = "dump_keymap", .option = OPTION_DUMP_KEYMAP, .value = false, .config = false},
+   {.name = "check_keymap", .option = OPTION_CHECK_KEYMAP, .value = false, .config = false},
+   {.name = "selftest", .option = OPTION_SELFTEST, .value = false, .config = false},
+   {.name = "debounce", .option = 'D', .value = true, .config = true, .error = "Invalid debounce window", .code = -35},
+   {.name = "rate_limit", .option = 'R', .value = true, .config = true, .error = "Invalid rate limit", .code = -40},
+   {.name = "quarantine", .option = 'Q', .value = true, .config = true, .error = "Invalid quarantine threshold", .code = -41},
+   {.name = "autorepeat", .option = 'A', .value = true, .config = true, .error = "Invalid autorepeat", .code = -47},
+   {.name = "key_counts", .option = 'K', .value = true, .config = true, .values = countsValues, .error = "Invalid key count format", .code = -34},
+   {.name = "overflow", .option = 'O', .value = true, .config = true, .values = overflowValues, .error = "Invalid overflow policy", .code = -38},
+   {.name = "flow_control", .option = 'H', .value = false, .config = true},
+   {.name = "batch", .option = 'B', .value = false, .config = true},
+   {.name = "threads", .option = 'T', .value = false, .config = true},
+   {.name = "loop", .option = 'L', .value = true, .config = true, .values = loopValues, .error = "Invalid event loop", .code = -31},
+   {.name = "rt_priority", .option = 'r', .value = true, .config = true, .error = "Invalid real-time priority", .code = -30},
+   {.name = "user", .option = 'u', .value = true, .config = true},
+   {.name = "upgrade", .option = 'U', .value = true, .config = true},
+   {.name = "stats_page", .option = 'P', .value = true, .config = true},
+   {.name = "metrics", .option = 'M', .value = true, .config = true, .error = "Invalid metrics exporter", .code = -44},
+   {.name = "seccomp", .option = 'z', .value = false, .config = true},
+   {.name = "profile", .option = OPTION_PROFILE, .value = false, .config = true},
+   {.name = "fork", .option = 'f', .value = false, .config = true},
+   {.name = "verbose", .option = 'v', .value = false, .config = true},
+   {.name = "config", .option = 'c', .value = true, .config = false},
+   {.name = "help", .option = 'h', .value = false, .config = false}
+};
+
+// perf_event counters profiled, task-clock only replaces cycles
+local const profilecounter_t profileCounters[] =
+{
+   {.name = "cycles", .type = PERF_TYPE_HARDWARE, .config = PERF_COUNT_HW_CPU_CYCLES},
+   {.name = "instructions", .type = PERF_TYPE_HARDWARE, .config = PERF_COUNT_HW_INSTRUCTIONS},
+   {.name = "cache_misses", .type = PERF_TYPE_HARDWARE, .config = PERF_COUNT_HW_CACHE_MISSES},
+   {.name = "task_clock_ns", .type = PERF_TYPE_SOFTWARE, .config = PERF_COUNT_SW_TASK_CLOCK},
+   {.name = "context_switches", .type = PERF_TYPE_SOFTWARE, .config = PERF_COUNT_SW_CONTEXT_SWITCHES}
+};
+
+// Configuration file text the string settings point into
+local char     configText[CONFIG_FILE_SIZE];
+
+// Events batched into a single write to the output
+local struct input_event   frame[FRAME_EVENTS];
+local size_t               frameCount = 0;
+
 // Keymap
 local keymap_t keymap[KEYMAPS][KEYS_PER_MAP];  // Scroll to the bottom of the file for definition
 
@@ -140,15 +783,102 @@ config_t appConfig = {  .speed = B300,
                         .databits = DATABITS_8,
                         .stopbits = STOPBITS_1,
                         .keymap = KEYMAP_KAYPRO,
+                        .errors = ERRORS_IGNORE,
+                        .output = OUTPUT_UINPUT,
+                        .outputPath = NULL,
+                        .user = NULL,
+                        .upgradePath = NULL,
+                        .statsPath = NULL,
+                        .metrics = METRICS_NONE,
+                        .metricsPath = NULL,
+                        .seccomp = false,
+                        .batch = false,
+                        .rtPriority = 0,
+                        .loop = LOOP_EPOLL,
+                        .threads = false,
+                        .flowControl = false,
+                        .counts = COUNTS_CSV,
+                        .debounceNs = 0,
+                        .rateIntervalNs = 0,
+                        .rateBurstNs = 0,
+                        .quarantineBytes = 0,
+                        .remap = NULL,
+                        .overflow = OVERFLOW_DROP,
+                        .dumpKeymap = false,
+                        .checkKeymap = false,
                         .tty = "/dev/ttyAMA4",
                         .fork = false,
-                        .verbose = false};
+                        .verbose = false,
+                        .feedback = false,
+                        .feedbackBytes = {FEEDBACK_NONE, FEEDBACK_NONE, FEEDBACK_NONE, FEEDBACK_NONE}};
 
 // Local function prototypes **************************************************
 // Application ctrl
 local void parseCommandLine(  int argc,      // Total count of arguments
                               char *argv[]); // Array of pointers to the argument strings
 
+local const option_t *findOption(int option);   // Short option character or OPTION_DEVICE
+
+local int applyOption(  const option_t *opt,    // Option to apply
+                        char *value,         // Option value or NULL
+                        char **error);       // Description of the error
+
+local int parseBool(char *str);              // on/off value
+
+local int loadConfig(char *path,             // Path/Name of the configuration file
+                     bool required,          // Error if the file doesn't exist
+                     int *line,              // Line number of the error
+                     char **error);          // Description of the error
+
+local int parseConfig(  char *text,          // Configuration text, modified in place
+                        size_t length,       // Length of the text w/o nul terminator
+                        int *line,           // Line number of the error
+                        char **error);       // Description of the error
+
+local bool parseFeedback(char *str);         // Comma separated list of feedback bytes
+
+local bool parseBus(char *str);              // Comma separated list of bus addresses and key maps
+
+local bool parseMetrics(char *str);          // socket:<path> or file:<path>
+
+local bool compileKeymap(const char *rules); // Comma separated list of remap rules, or NULL
+
+local const char *parseKey(const char *str,  // Key name or code
+                           int *code);       // Key code parsed
+
+local void dumpKeymap(FILE *output);         // Stream to display the key map
+
+local const char *keymapName(int map);       // Key map index
+
+local const char *deviceKeymapName(const device_t *device);   // Keypad
+
+local int checkKeymaps(FILE *output);        // Stream to display the results
+
+local int checkKeymap(const keymap_t *map,   // Key map to check
+                      const char *name,      // Name of the key map
+                      FILE *output);         // Stream to display the problems
+
+local ssize_t writeCheck(int fd,                       // Unused
+                         const void *data,             // Events to record
+                         size_t size);                 // Bytes of events
+
+local int runSelftest(FILE *output);                   // Stream to display the results
+
+local int openEvdev(int uinputFd,                      // File descriptor for Uinput
+                    char *path,                        // Event device path found
+                    size_t size);                      // Size of path
+
+local ssize_t writeSelftest(int fd,                    // File descriptor for Uinput
+                            const void *data,          // Events to write
+                            size_t size);              // Bytes of events
+
+local void expectEvent(const struct input_event *ie);  // Event written to uinput
+
+local void readSelftest(void);
+
+local int compareLatency(const void *a,                // Latency in nanoseconds
+                         const void *b);               // Latency in nanoseconds
+
 local void displayUsage(FILE *ouput);        // File pointer to output the text to
 
 local void exitApp(  char* error_str,        // Descriptive char string
@@ -156,15 +886,58 @@ local void exitApp(  char* error_str,        // Descriptive char string
                      int return_code);       // Return code to use for exit()
 
 // Uinput Interface
-local void emit(  int fd,              // File descriptor for Uinput
+local void emit(  int fd,              // File descriptor for the output
                   int type,            // Type of code
                   int code,            // Key code
                   int val);            // Code modifier
 
-local void emitKey(  int fd,           // File descriptor for Uinput
-                     keymap_t *key);   // Keymap entry for the key to be passed to Uinput
+local void emitKey(  int fd,           // File descriptor for the output
+                     keymap_t *key);   // Keymap entry for the key to be passed to the output
+
+local void flushFrame(int fd);         // File descriptor for the output
+
+local int connectUinput(char *path);   // Unused
+
+local void disconnectUinput(int fd);   // File descriptor for Uinput
+
+local void releaseKeys(int fd);        // File descriptor for the output
+
+local void readUinput(  int fd,        // File descriptor for the output
+                        int serialFd); // File descriptor of the serial device to send feedback to
+
+// Output backends
+local bool parseOutput(char *str);     // Output name w/optional :path
+
+local int connectOutput(void);
+
+local void disconnectOutput(void);
+
+local void disconnectFd(int fd);       // File descriptor for the output
+
+local int connectStdout(char *path);   // Unused
+
+local int connectFile(char *path);     // Path/Name of the file
+
+local int connectSocket(char *path);   // Path/Name of the Unix socket
+
+local ssize_t writeFd(  int fd,                       // File descriptor for the output
+                        const void *data,             // Events to write
+                        size_t size);                 // Bytes of events
+
+local ssize_t writeSocket( int fd,                       // File descriptor for the socket
+                           const void *data,             // Events to write
+                           size_t size);                 // Bytes of events
+
+local void writeOutput( int fd,                       // File descriptor for the output
+                        const void *data,             // Events to write
+                        size_t size);                 // Bytes of events
 
-local int connectUinput(void);
+local bool queuePending(const unsigned char *data,    // Events the output didn't accept
+                        size_t size);                 // Bytes of events
+
+local void flushPending(int fd);                      // File descriptor for the output
+
+local void drainPending(int fd);                      // File descriptor for the output
 
 // Serial port
 local int getSerialConfig( int fd,                    // File descriptor
@@ -177,16 +950,300 @@ local int configSerial( int         fd,               // File descriptor for /de
                         speed_t     speed,            // Baudrate B? [B50 to B115200]
                         parity_t    parity,           // Parity [PARITY_NONE | PARITY_ODD | PARITY_EVEN]
                         databits_t  dataBits,         // Number of data bits [DATABITS_5 | DATABITS_6 | DATABITS_7 | DATABITS_8]
-                        stopbits_t  stopBits);        // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+                        stopbits_t  stopBits,         // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+                        errors_t    errors,           // Serial error handling [ERRORS_IGNORE | ERRORS_COUNT | ERRORS_DROP]
+                        bool        flowControl);     // RTS/CTS hardware flow control
 
 local int openSerial(char *tty,                       // Path/Name of the tty device
                      speed_t     speed,               // Baudrate B? [B50 to B115200]
                      parity_t    parity,              // Parity [PARITY_NONE | PARITY_ODD | PARITY_EVEN]
                      databits_t  dataBits,            // Number of data bits [DATABITS_5 | DATABITS_6 | DATABITS_7 | DATABITS_8]
-                     stopbits_t  stopBits);           // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+                     stopbits_t  stopBits,            // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+                     errors_t    errors,              // Serial error handling [ERRORS_IGNORE | ERRORS_COUNT | ERRORS_DROP]
+                     bool        flowControl);        // RTS/CTS hardware flow control
+
+local void throttleSerial(bool throttle);             // Deassert RTS to stop the sender, or reassert it
 
 local int closeSerial(int fd);                        // File descriptor of serial device
 
+local void readSerial(  int fd,                       // File descriptor of serial device
+                        int uinputFd);                // File descriptor for Uinput
+
+local void processKeys( unsigned char *keys,          // Keys read from the serial port
+                        ssize_t count,                // Number of keys or read error
+                        uint64_t time,                // CLOCK_MONOTONIC nanoseconds when read
+                        int uinputFd);                // File descriptor for Uinput
+
+local void processKey(  unsigned char key,            // Key read from the serial port
+                        uint64_t time,                // CLOCK_MONOTONIC nanoseconds when read
+                        int uinputFd);                // File descriptor for Uinput
+
+local device_t *deframeSerial(unsigned char key);     // Byte read from the serial port
+
+local void countBadByte(device_t *device,             // Keypad that sent the byte
+                        uint64_t time);               // CLOCK_MONOTONIC nanoseconds the byte was read
+
+local uint64_t monotonicTime(void);
+
+local void queueSerial( int fd,                       // File descriptor of serial device
+                        unsigned char data);          // Byte to send to the keyboard
+
+local void flushSerial(int fd);                       // File descriptor of serial device
+
+local bool unmarkSerial(unsigned char *key);          // Byte received, returns true if it should be mapped
+
+local void pollSerialErrors(int fd);                  // File descriptor of serial device
+
+// Privilege separation
+local void dropPrivileges(char *user);                // User name w/optional :group
+
+local void installSeccomp(void);
+
+// Reader thread
+local void startReader(int fd);                       // File descriptor of serial device
+
+local void *runReader(void *arg);                     // File descriptor of serial device
+
+local void *stopReading(unsigned head,                // Keys queued by the reader
+                        int error);                   // errno of the failure, 0 if the port closed
+
+local void readQueue(int uinputFd);                   // File descriptor for Uinput
+
+// io_uring event loop
+local bool setupUring(void);
+
+local struct io_uring_sqe *getSqe(  int fd,           // File descriptor of the operation
+                                    uringop_t op);    // Operation tag returned in the completion
+
+local void submitUring(bool wait);                    // Wait for at least one completion
+
+local bool popCqe(uringcqe_t *cqe);                   // Completion popped from the ring
+
+local bool nextCqe(uringcqe_t *cqe);                  // Completion popped from the stash or ring
+
+local void stashCqe(const uringcqe_t *cqe);           // Completion to defer
+
+local void armSerialRead(int fd);                     // File descriptor of serial device
+
+local void armWatch( int fd,                          // File descriptor to watch
+                     unsigned int events);            // poll events to watch for
+
+local void runUring(void);
+
+local void onUringCompletion(uringcqe_t *cqe);        // Completion to handle
+
+local ssize_t writeUring(  int fd,                       // File descriptor for the output
+                           const void *data,             // Events to write
+                           size_t size);                 // Bytes of events
+
+local void submitWrite(int fd);                       // File descriptor for the output
+
+local void stopUring(void);
+
+// Upgrade
+local bool takeOver(char *path);                      // Path of the upgrade socket
+
+local int listenUpgrade(char *path);                  // Path of the upgrade socket
+
+local void acceptUpgrade(void);
+
+local void closeUpgradeClient(void);
+
+local void handOff(void);
+
+local void stopSerialReads(int fd);                   // File descriptor of serial device
+
+local void cancelSerialRead(int fd);                  // File descriptor of serial device
+
+// Systemd
+local void connectNotify(void);
+
+local void notifySystemd(const char *state);          // Newline separated list of state assignments
+
+// Event loop
+local void watchEvents( int fd,                       // File descriptor to watch
+                        unsigned int events,          // epoll events to watch for
+                        int op);                      // EPOLL_CTL_ADD | EPOLL_CTL_MOD
+
+local void dispatchEvent(int fd,                      // File descriptor that is ready
+                          unsigned int events);       // epoll events
+                          
+local int createTimer(int periodMs);                  // Timer period in milliseconds
+
+local void onTimer(int serialFd);                     // File descriptor of serial device
+
+local bool isModifier(int code);                       // Key code
+
+local void startRepeat(uint64_t time);                 // CLOCK_MONOTONIC nanoseconds the key was read
+
+local void repeatKey(uint64_t now);                    // CLOCK_MONOTONIC nanoseconds
+
+local void scheduleTimer(void);
+
+local int createSignals(void);
+
+local void onSignal(void);
+
+local void createStatsPage(char *path);              // Path of the stats page
+
+local void closeStatsPage(void);
+
+local void publishStats(uint64_t now);                // CLOCK_MONOTONIC nanoseconds
+
+local void recordLatency(uint64_t now,                // CLOCK_MONOTONIC nanoseconds the events were written
+                         uint64_t time,               // CLOCK_MONOTONIC nanoseconds the keys were read
+                         uint64_t keys);              // Number of keys
+
+local void startMetrics(char *path);                  // Metrics socket or file
+
+local void serveMetrics(void);
+
+local void chownMetricsFile(uid_t uid,                // User to give the metrics file to
+                             gid_t gid);              // Group to give it to
+
+local bool writeMetricsFile(void);
+
+local void appendMetrics(const char *format, ...);    // printf format and arguments
+
+local void appendMetricHeader(const char *name,       // Metric name
+                              const char *type,       // counter, gauge, or histogram
+                              const char *help);      // Description
+
+local void appendMetric(const char *name,             // Metric name
+                        const char *type,             // counter or gauge
+                        const char *help,             // Description
+                        double value);                // Value
+
+local void appendKeypadMetric(const char *name,       // Metric name
+                              const char *help,       // Description
+                              size_t offset);         // Offset of the counter in device_t
+
+local void formatMetrics(void);
+
+local void startProfile(void);
+
+local int openCounter(const profilecounter_t *counter);  // Counter to open in the group
+
+local void readCounters(uint64_t *values);            // Counts in the order of profile.counters
+
+local void endProfile(unsigned long keys);            // Keys written since the batch started
+
+local uint64_t profilePercentile(int counter,         // Index in profile.counters
+                                 unsigned percent);   // Percentile, 1-100
+
+local void dumpProfile(FILE *output);                 // File pointer to output the profile to
+
+local void dumpStats(FILE *output);                   // File pointer to output the stats to
+
+local void dumpKeyCounts(FILE *output);               // File pointer to output the stats to
+
+// Output Backends ************************************************************
+// Indexed by outputs_t
+local output_t outputs[OUTPUTS] =
+{
+   {.name = "uinput", .path = false, .feedback = true, .connect = connectUinput, .write = writeFd, .disconnect = disconnectUinput},
+   {.name = "stdout", .path = false, .feedback = false, .connect = connectStdout, .write = writeFd, .disconnect = disconnectFd},
+   {.name = "file", .path = true, .feedback = false, .connect = connectFile, .write = writeFd, .disconnect = disconnectFd},
+   {.name = "socket", .path = true, .feedback = true, .connect = connectSocket, .write = writeSocket, .disconnect = disconnectFd}
+};
+
+// System calls allowed by the seccomp filter once the event loop is running
+local const int allowedSyscalls[] =
+{
+   __NR_read, __NR_write, __NR_close, __NR_ioctl, __NR_fcntl,
+   __NR_epoll_ctl, __NR_epoll_pwait, __NR_sendto,
+   __NR_brk, __NR_munmap, __NR_clock_gettime,
+   __NR_rt_sigreturn, __NR_restart_syscall, __NR_exit, __NR_exit_group,
+#ifdef __NR_epoll_wait
+   __NR_epoll_wait,
+#endif
+#ifdef __NR_io_uring_enter
+   __NR_io_uring_enter,
+#endif
+#ifdef __NR_ppoll
+   __NR_ppoll,
+#endif
+#ifdef __NR_poll
+   __NR_poll,
+#endif
+#ifdef __NR_futex
+   __NR_futex,
+#endif
+#ifdef __NR_mmap
+   __NR_mmap,
+#endif
+#ifdef __NR_fstat
+   __NR_fstat,
+#endif
+#ifdef __NR_newfstatat
+   __NR_newfstatat,
+#endif
+#ifdef __NR_mmap2
+   __NR_mmap2,
+#endif
+#ifdef __NR_fstat64
+   __NR_fstat64,
+#endif
+#ifdef __NR_clock_gettime64
+   __NR_clock_gettime64,
+#endif
+#ifdef __NR_send
+   __NR_send,
+#endif
+   // glibc seeds malloc on its first call, such as buffering stdout to a file
+#ifdef __NR_getrandom
+   __NR_getrandom,
+#endif
+   // glibc registers the reader thread as it starts and blocks signals as
+   // it exits. startReader() waits for the start before the filter is
+   // installed, the exit runs under it
+   __NR_set_robust_list, __NR_rt_sigprocmask,
+#ifdef __NR_rseq
+   __NR_rseq,
+#endif
+   // Scheduling the timer for autorepeat
+#ifdef __NR_timerfd_settime
+   __NR_timerfd_settime,
+#endif
+#ifdef __NR_timerfd_settime64
+   __NR_timerfd_settime64,
+#endif
+   // Handing off to a new serkey
+   __NR_accept4, __NR_recvfrom, __NR_sendmsg, __NR_madvise,
+#ifdef __NR_accept
+   __NR_accept,
+#endif
+#ifdef __NR_unlink
+   __NR_unlink,
+#endif
+#ifdef __NR_unlinkat
+   __NR_unlinkat,
+#endif
+};
+
+// System calls to write the metrics file, allowed only if it's enabled
+local const int metricsSyscalls[] =
+{
+#ifdef __NR_open
+   __NR_open,
+#endif
+#ifdef __NR_openat
+   __NR_openat,
+#endif
+#ifdef __NR_rename
+   __NR_rename,
+#endif
+#ifdef __NR_renameat
+   __NR_renameat,
+#endif
+#ifdef __NR_renameat2
+   __NR_renameat2,
+#endif
+};
+
+// Write function of the selected output, set once by connectOutput()
+local ssize_t  (*writeEvents)(int fd, const void *data, size_t size) = writeFd;
+
 /*
  * Main Entry Point ***********************************************************
  */
@@ -194,6 +1251,9 @@ int main(int argc, char *argv[])
 {
    // Parse the command line and setup the config
    parseCommandLine(argc, argv);
+   // Give each keypad its byte counts
+   for(int i=0;i<=BUS_DEVICES;++i)
+      devices[i].keyCounts = keyCountBuffer[i];
 
    // If enabled fork process closing the parent and returning without error
    if(appConfig.fork)
@@ -203,47 +1263,128 @@ int main(int argc, char *argv[])
       LOG("Forked daemon\n\r");
    }
 
-   // Open and configure the serial port
    int fdSerial;
-   if((fdSerial = openSerial(appConfig.tty, appConfig.speed, appConfig.parity, appConfig.databits, appConfig.stopbits))<1)
-      exitApp("Unable to open serial device",false,-1);
-   LOG("Opened and configured serial device\n\r");
+   // If a serkey is running, take over its serial port and output so the
+   // virtual keyboard isn't recreated
+   if(appConfig.upgradePath && takeOver(appConfig.upgradePath))
+   {
+      fdSerial = ttyFd;
+      LOG("Took over the serial device and %s\n\r", outputs[appConfig.output].name);
+   }
+   else
+   {
+      // Open and configure the serial port
+      if((fdSerial = openSerial(appConfig.tty, appConfig.speed, appConfig.parity, appConfig.databits, appConfig.stopbits, appConfig.errors, appConfig.flowControl))<1)
+         exitApp("Unable to open serial device",false,-1);
+      // Save the file descriptor so exitApp() restores the configuration
+      ttyFd = fdSerial;
+      LOG("Opened and configured serial device\n\r");
 
-   // Connect to the uinput kernel module
-   int uinput_fd = connectUinput();
-   LOG("Connected to uintput\n\r");
+      // Connect to the output (uinput kernel module by default)
+      outputFd = connectOutput();
+      LOG("Connected to %s\n\r", outputs[appConfig.output].name);
+   }
 
-   // Loop forever reading keystrokes from the serial port and writing the 
-   // mapped key code to Uninput 
-   do
+   // Create the event loop and watch the serial port and uinput. If io_uring
+   // isn't available, fall back to epoll
+   if(appConfig.loop == LOOP_URING && appConfig.threads)
+      LOG("The reader thread uses epoll\n\r");
+   else if(appConfig.loop == LOOP_URING && !setupUring())
+      LOG("io_uring is not available, using epoll\n\r");
+   if(uring.fd == -1 && (epollFd = epoll_create1(0))<0)
+      exitApp("Unable to create the event loop", false, -18);
+   // If reading in a separate thread, the event loop only writes feedback
+   if(appConfig.threads)
+      serialEvents = 0;
+   watchEvents(fdSerial, serialEvents, EPOLL_CTL_ADD);
+   // If feedback is enabled, watch the output for LED and sound events
+   if(appConfig.feedback && outputs[appConfig.output].feedback)
    {
-      unsigned char  key;
-      size_t         count;
+      outputEvents = EPOLLIN;
+      watchEvents(outputFd, outputEvents, EPOLL_CTL_ADD);
+   }
+   // Connect to the systemd notify socket if started by systemd
+   connectNotify();
 
-      // Read the next key from the serial port
-      // This call is blocking
-      count = read(fdSerial, &key, sizeof(key));
+   // If enabled, publish the stats for monitors and export the metrics
+   if(appConfig.statsPath)
+      createStatsPage(appConfig.statsPath);
+   if(appConfig.metrics != METRICS_NONE)
+      startMetrics(appConfig.metricsPath);
+   measureLatency = statsPage || appConfig.metrics != METRICS_NONE;
+   // If enabled, count the cycles and instructions each key costs
+   if(appConfig.profile)
+      startProfile();
 
-      // If read a key from from the serial port...
-      if(count!=0)
-      {
-         // Display it to stdout
-         if(isprint(key))
-            LOG(" In - Key: \"%c\" code: %03d ", (char)key, key);
-         else
-            LOG(" In - Key: N/A code: %03d ", key);
+   // If serial errors are marked, systemd expects watchdog pings, stats
+   // are published, the metrics file is written, or keys autorepeat, start
+   // the timer. Ping the watchdog at least twice per watchdog period
+   if(appConfig.errors != ERRORS_IGNORE || watchdogMs || statsPage ||
+      appConfig.metrics == METRICS_FILE || appConfig.repeatDelayNs)
+      watchEvents(timerFd = createTimer((watchdogMs && watchdogMs/2 < TIMER_TICK_MS)?watchdogMs/2:TIMER_TICK_MS),
+                  EPOLLIN, EPOLL_CTL_ADD);
+   // Watch for the signals to dump the statistics and shut down
+   watchEvents(signalFd = createSignals(), EPOLLIN, EPOLL_CTL_ADD);
+   // If enabled, listen for the next serkey to hand off to
+   if(appConfig.upgradePath)
+      watchEvents(upgradeFd = listenUpgrade(appConfig.upgradePath), EPOLLIN, EPOLL_CTL_ADD);
 
-         // Send the mapped key code to uinput
-         emitKey(uinput_fd, &keymap[appConfig.keymap][key]);
-      }
-      else
-      {
-         if(errno!=0)
-            exitApp("read returned an error", false, -2);
-         else
-            exitApp("read returned zero bytes", false, 0);
+   // If enabled, run the event loop at a real-time priority
+   if(appConfig.rtPriority)
+   {
+      struct sched_param param = {.sched_priority = appConfig.rtPriority};
+
+      if(sched_setscheduler(0, SCHED_FIFO, &param))
+         exitApp("Unable to set the real-time priority", false, -30);
+      LOG("Running at SCHED_FIFO priority %d\n\r", appConfig.rtPriority);
+   }
+
+   // If enabled, read the serial port in its own thread. Signals are blocked
+   // so the thread inherits the mask and they reach the signalfd
+   if(appConfig.threads)
+      startReader(fdSerial);
+
+   // The devices are open, drop to the unprivileged user and restrict the
+   // system calls to those the event loop needs
+   if(appConfig.user)
+      dropPrivileges(appConfig.user);
+   if(appConfig.seccomp)
+      installSeccomp();
+   // Write the metrics file as the user that will keep writing it, so a
+   // directory it can't write fails now instead of leaving stale metrics
+   if(appConfig.metrics == METRICS_FILE && !writeMetricsFile())
+      exitApp("Unable to write the metrics file", false, -44);
+
+   // Tell systemd the serial port and output are ready
+   notifySystemd("READY=1");
+
+   // If using io_uring, run its loop instead
+   if(uring.fd != -1)
+      runUring();
+
+   // Loop forever reading keystrokes from the serial port and writing the 
+   // mapped key code to Uninput. Feedback from uinput is queued to the
+   // serial port and written as the port becomes writable
+   do
+   {
+      struct epoll_event   events[EVENTS_PER_WAIT];
+      int                  count;
+
+      // Wait for the serial port or uinput to become ready
+      // This call is blocking
+      count = epoll_wait(epollFd, events, EVENTS_PER_WAIT, -1);
+      ++stats.waits;
+      if(count<0)
+      {
+         if(errno==EINTR)
+            continue;
+         exitApp("epoll_wait returned an error", false, -19);
       }
 
+      // For each ready file descriptor...
+      for(int i=0;i<count;++i)
+         dispatchEvent(events[i].data.fd, events[i].events);
+
    } while(true);
 
    return 0;
@@ -251,411 +1392,4421 @@ int main(int argc, char *argv[])
 
 // Program Runtime Functions **************************************************
 /*
- * Parse the application command line and set up the configuration
+ * Parse the application command line and set up the configuration. The
+ * configuration file is loaded first so the command line overrides it
  */
 local void parseCommandLine(int argc, char *argv[])
 {
-   // For each command line argument...
-   for(int i=1;i<=argc-1;++i)
+   persistent struct option   longOptions[OPTIONS_MAX + 1];
+   persistent char            shortOptions[2 * OPTIONS_MAX + 2];
+   char                       *path = CONFIG_FILE, *short_options = shortOptions, *error;
+   bool                       required = false;
+   int                        ret, line, option, count = 0;
+
+   // Build the getopt tables from the option table. A leading : reports a
+   // missing value separately from an unknown option
+   *short_options++ = ':';
+   for(int i=0;i<sizeof(options)/sizeof(options[0]);++i)
+   {
+      longOptions[count].name = options[i].name;
+      longOptions[count].has_arg = options[i].value?required_argument:no_argument;
+      longOptions[count].flag = NULL;
+      longOptions[count++].val = options[i].option;
+
+      if(options[i].option < OPTION_DEVICE)
+      {
+         *short_options++ = (char)options[i].option;
+         if(options[i].value)
+            *short_options++ = ':';
+      }
+   }
+   memset(&longOptions[count], 0, sizeof(longOptions[count]));
+   *short_options = '\0';
+
+   // If a configuration file was provided, it must exist. getopt permutes
+   // the arguments it scans, so search a copy
+   char *args[argc + 1];
+
+   memcpy(args, argv, sizeof(args));
+   opterr = 0;
+   while((option = getopt_long(argc, args, shortOptions, longOptions, NULL)) != -1)
+      if(option == 'c')
+      {
+         path = optarg;
+         required = true;
+      }
+
+   // Load the configuration file
+   if((ret = loadConfig(path, required, &line, &error)))
+   {
+      if(line)
+         fprintf(stderr, "%s:%d: ", path, line);
+      exitApp(error, false, ret);
+   }
+
+   // For each command line option...
+   optind = 0;
+   while((option = getopt_long(argc, argv, shortOptions, longOptions, NULL)) != -1)
+   {
+      switch(option)
+      {
+         case 'c':
+            // Loaded above
+            break;
+         case 'h':
+            exitApp(NULL, true, 0);
+            break;
+         case ':':
+            exitApp("Missing option value", true, -9);
+            break;
+         case '?':
+            // If -?, display the usage...
+            if(optopt == '?')
+               exitApp(NULL, true, 0);
+            exitApp("Unknown switch", true, -9);
+            break;
+         default:
+            if((ret = applyOption(findOption(option), optarg, &error)))
+               exitApp(error, true, ret);
+      }
+   }
+
+   // The remaining argument is the device path/name
+   for(int i=optind;i<argc;++i)
+      appConfig.tty = argv[i];
+
+   // Apply the remapping rules to the selected key map
+   if(!compileKeymap(appConfig.remap))
+   {
+      errno = EINVAL;
+      exitApp("Invalid remap rule", false, -36);
+   }
+
+   // If only displaying the key map, no device is needed
+   if(appConfig.dumpKeymap)
+   {
+      dumpKeymap(stdout);
+      exitApp(NULL, false, 0);
+   }
+
+   // If only checking the key maps, no device is needed
+   if(appConfig.checkKeymap)
    {
-      // If command line switch "-" character...
-      if(argv[i][0]=='-')
+      if(checkKeymaps(stdout))
       {
-         int baudrate, databits, stopbits;
+         errno = EINVAL;
+         exitApp("A key map has unbalanced events", false, -37);
+      }
+      exitApp(NULL, false, 0);
+   }
+
+   // If only testing the virtual keyboard, no device is needed
+   if(appConfig.selftest)
+   {
+      if(runSelftest(stdout))
+         exitApp("The events read back don't match those written", false, -46);
+      exitApp(NULL, false, 0);
+   }
+
+   if(appConfig.tty==NULL)
+      exitApp("No serial device provided", true, -11);
+}
+
+/*
+ * Find an option in the option table
+ */
+local const option_t *findOption(int option)
+{
+   for(int i=0;i<sizeof(options)/sizeof(options[0]);++i)
+      if(options[i].option == option)
+         return(&options[i]);
+   return(NULL);
+}
 
-         // Decode the command line switch and apply...
-         switch(argv[i][1])
+/*
+ * Apply an option from the command line or configuration file. A NULL value
+ * enables an on/off option. Returns 0 or the error code and description
+ */
+local int applyOption(const option_t *opt, char *value, char **error)
+{
+   int   number = 0, j;
+   char  *end;
+
+   // If unknown option...
+   if(opt == NULL)
+   {
+      *error = "Unknown switch";
+      return(-9);
+   }
+
+   // If the option takes a value...
+   if(opt->value)
+   {
+      // If no value was provided...
+      if(value == NULL)
+      {
+         *error = "Missing option value";
+         return(-9);
+      }
+      // If the value must be one of a list, look it up...
+      if(opt->values)
+      {
+         for(j=0;opt->values[j].name && strcmp(value, opt->values[j].name);++j);
+         if(opt->values[j].name == NULL)
          {
-            case 'b':
-               baudrate = atoi(argv[++i]);
-               // If the baudrate is not 0...
-               for(int j=0;j<sizeof(speeds)/sizeof(baudrate_t);++j)
-                  if(speeds[j].baudrate==baudrate)
-                  {
-                     appConfig.speed = speeds[j].speed;
-                     break;
-                  }
-               // If searched to the end of the table of speeds...
-               if(i==sizeof(speeds)/sizeof(baudrate_t))
-                  exitApp("Invalid Baudrate", true, -4);
-               break;
-            case 'p':
-               ++i;
-               // If valid parity setting...
-               if(!strcmp(argv[i],"odd"))
-                  appConfig.parity = PARITY_ODD;
-               else if(!strcmp(argv[i],"even"))
-                  appConfig.parity = PARITY_EVEN;
-               else if(!strcmp(argv[i],"none"))
-                  appConfig.parity=PARITY_NONE;
-               // Else error...
-               else
-                  exitApp("Invalid parity", true, -5);
-               break;
-            case 'd':
-               databits = atoi(argv[++i]);
-               // If valid data bits...
-               if(databits == 5)
-                  appConfig.databits = DATABITS_5;
-               else if(databits == 6)
-                  appConfig.databits = DATABITS_6;
-               else if(databits == 7)
-                  appConfig.databits = DATABITS_7;
-               else if(databits == 6)
-                  appConfig.databits = DATABITS_8;
-               // Else error...
-               else 
-                  exitApp("Invalid data bits", true, -6);
-               break;
-            case 's':
-               stopbits = atoi(argv[++i]);
-               // If valid stop bits...
-               if(stopbits == 1)
-                  appConfig.stopbits = STOPBITS_1;
-               else if(stopbits == 2)
-                  appConfig.stopbits = STOPBITS_2;
-               // Else error...
-               else
-                  exitApp("Invalid stop bits", true, -7);
-               break;
-            case 'k':
-               ++i;
-               // If kaypro key map setting...
-               if(!strcmp(argv[i],"kaypro"))
-                  appConfig.keymap = KEYMAP_KAYPRO;
-               // Else if media_keys key map setting...
-               else if(!strcmp(argv[i],"media_keys"))
-                  appConfig.keymap = KEYMAP_MEDIA_KEYS;
-               // Else if ascii key map setting...
-               else if(!strcmp(argv[i],"ascii"))
-                  appConfig.keymap = KEYMAP_ASCII;
-               // Else error...
-               else
-                  exitApp("Invalid key map", true, -8);
-               break;
-            case 'f':
-               appConfig.fork = true;
-               break;
-            case 'v':
-               appConfig.verbose = true;
+            *error = opt->error;
+            return(opt->code);
+         }
+         number = opt->values[j].value;
+      }
+   }
+   // Else on/off option, no value enables it...
+   else
+   {
+      if((number = value?parseBool(value):1) < 0)
+      {
+         *error = "Invalid on/off value";
+         return(-16);
+      }
+   }
+
+   switch(opt->option)
+   {
+      case 'b':
+         number = (int)strtol(value, &end, 10);
+         // Search the table of speeds for the baudrate...
+         for(j=0;j<sizeof(speeds)/sizeof(baudrate_t);++j)
+            if(speeds[j].baudrate==number && *end=='\0')
+            {
+               appConfig.speed = speeds[j].speed;
                break;
-            case 'h':
-            case '?':
-               exitApp(NULL, true, 0);
+            }
+         // If searched to the end of the table of speeds...
+         if(j==sizeof(speeds)/sizeof(baudrate_t))
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         break;
+      case 'p':
+         appConfig.parity = (parity_t)number;
+         break;
+      case 'd':
+         appConfig.databits = (databits_t)number;
+         break;
+      case 's':
+         appConfig.stopbits = (stopbits_t)number;
+         break;
+      case 'k':
+         appConfig.keymap = (keymaps_t)number;
+         break;
+      case 'e':
+         appConfig.errors = (errors_t)number;
+         break;
+      case 'L':
+         appConfig.loop = (loop_t)number;
+         break;
+      case 'K':
+         appConfig.counts = (counts_t)number;
+         break;
+      case 'O':
+         appConfig.overflow = (overflow_t)number;
+         break;
+      case 'l':
+         // If valid feedback byte list...
+         if(!parseFeedback(value))
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         appConfig.feedback = true;
+         break;
+      case 'o':
+         // If valid output...
+         if(!parseOutput(value))
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         break;
+      case 'a':
+         // If not a valid address list...
+         if(!parseBus(value))
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         break;
+      case 'm':
+         appConfig.remap = value;
+         break;
+      case OPTION_DUMP_KEYMAP:
+         appConfig.dumpKeymap = true;
+         break;
+      case OPTION_CHECK_KEYMAP:
+         appConfig.checkKeymap = true;
+         break;
+      case OPTION_SELFTEST:
+         appConfig.selftest = true;
+         break;
+      case 'D':
+         number = (int)strtol(value, &end, 10);
+         // If not a valid window in milliseconds...
+         if(*end != '\0' || number < 0 || number > DEBOUNCE_MAX_MS)
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         appConfig.debounceNs = (uint64_t)number * 1000000;
+         break;
+      case 'R':
+         number = (int)strtol(value, &end, 10);
+         // The burst defaults to a second of keys
+         j = number;
+         if(*end == ',')
+            j = (int)strtol(end + 1, &end, 10);
+         // If not a valid rate and burst...
+         if(*end != '\0' || number < 0 || number > RATE_LIMIT_MAX || (number && (j < 1 || j > RATE_LIMIT_MAX)))
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         appConfig.rateIntervalNs = number?NS_PER_SEC / (uint64_t)number:0;
+         appConfig.rateBurstNs = number?(uint64_t)(j - 1) * appConfig.rateIntervalNs:0;
+         break;
+      case 'Q':
+         number = (int)strtol(value, &end, 10);
+         // If not a valid bytes per second...
+         if(*end != '\0' || number < 0)
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         appConfig.quarantineBytes = (unsigned long)number;
+         break;
+      case 'A':
+         number = (int)strtol(value, &end, 10);
+         j = REPEAT_RATE;
+         if(*end == ',')
+            j = (int)strtol(end + 1, &end, 10);
+         // If not a valid delay and rate...
+         if(*end != '\0' || number < 0 || number > REPEAT_DELAY_MAX_MS ||
+            j < 1 || j > REPEAT_RATE_MAX)
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         appConfig.repeatDelayNs = (uint64_t)number * 1000000ULL;
+         appConfig.repeatPeriodNs = NS_PER_SEC / (uint64_t)j;
+         break;
+      case 'r':
+         number = (int)strtol(value, &end, 10);
+         // If not a valid SCHED_FIFO priority...
+         if(*end != '\0' || number < sched_get_priority_min(SCHED_FIFO) || number > sched_get_priority_max(SCHED_FIFO))
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         appConfig.rtPriority = number;
+         break;
+      case 'u':
+         appConfig.user = value;
+         break;
+      case 'U':
+         appConfig.upgradePath = value;
+         break;
+      case 'P':
+         appConfig.statsPath = value;
+         break;
+      case 'M':
+         // If not a valid metrics socket or file...
+         if(!parseMetrics(value))
+         {
+            *error = opt->error;
+            return(opt->code);
+         }
+         break;
+      case OPTION_DEVICE:
+         appConfig.tty = value;
+         break;
+      case 'B':
+         appConfig.batch = number;
+         break;
+      case 'T':
+         appConfig.threads = number;
+         break;
+      case 'H':
+         appConfig.flowControl = number;
+         break;
+      case 'z':
+         appConfig.seccomp = number;
+         break;
+      case OPTION_PROFILE:
+         appConfig.profile = number;
+         break;
+      case 'f':
+         appConfig.fork = number;
+         break;
+      case 'v':
+         appConfig.verbose = number;
+         break;
+      default:
+         *error = "Unknown switch";
+         return(-9);
+   }
+
+   return(0);
+}
+
+/*
+ * Parse an on/off value. Returns 1 for on, 0 for off, or -1 if invalid
+ */
+local int parseBool(char *str)
+{
+   if(!strcmp(str,"true") || !strcmp(str,"yes") || !strcmp(str,"on") || !strcmp(str,"1"))
+      return(1);
+   if(!strcmp(str,"false") || !strcmp(str,"no") || !strcmp(str,"off") || !strcmp(str,"0"))
+      return(0);
+   return(-1);
+}
+
+/*
+ * Load the configuration file into the configuration buffer and parse it.
+ * The file is optional unless required. Returns 0 or the error code,
+ * description, and line number
+ */
+local int loadConfig(char *path, bool required, int *line, char **error)
+{
+   ssize_t  length;
+   int      fd;
+
+   *line = 0;
+
+   // If the file doesn't exist and isn't required, use the defaults...
+   if((fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+   {
+      if(!required && errno == ENOENT)
+         return(0);
+      *error = "Unable to open the configuration file";
+      return(-29);
+   }
+
+   // Read the whole file, leaving room for the nul terminator
+   length = read(fd, configText, sizeof(configText));
+   close(fd);
+   if(length < 0)
+   {
+      *error = "Unable to read the configuration file";
+      return(-29);
+   }
+   if(length == sizeof(configText))
+   {
+      *error = "Configuration file is too large";
+      return(-29);
+   }
+
+   return(parseConfig(configText, (size_t)length, line, error));
+}
+
+/*
+ * Parse the "name = value" lines of a configuration file in a single pass.
+ * Comments start with #. The text is tokenized in place, so no memory is
+ * allocated and the string settings point into the text. The text must have
+ * room for a nul terminator at text[length]. No I/O is performed, so the
+ * parser can be fed arbitrary input
+ */
+local int parseConfig(char *text, size_t length, int *line, char **error)
+{
+   char  *end = text + length;
+   int   ret;
+
+   *end = '\0';
+   *line = 0;
+
+   // For each line...
+   for(char *next=text;next<end;)
+   {
+      char  *name = next, *value, *eol;
+      const option_t *opt = NULL;
+
+      ++*line;
+
+      // Find the end of the line and the start of the next one
+      if((eol = memchr(name, '\n', (size_t)(end - name))) == NULL)
+         eol = end;
+      next = eol + 1;
+      *eol = '\0';
+
+      // Remove the comment
+      if((value = memchr(name, '#', (size_t)(eol - name))) != NULL)
+         *(eol = value) = '\0';
+
+      // Trim the line, skip it if blank
+      while(name < eol && isspace((unsigned char)*name))
+         ++name;
+      while(eol > name && isspace((unsigned char)eol[-1]))
+         *--eol = '\0';
+      if(name == eol)
+         continue;
+
+      // Split the name and value at the =
+      if((value = memchr(name, '=', (size_t)(eol - name))) == NULL)
+      {
+         *error = "Expected name = value";
+         return(-29);
+      }
+      for(char *trim=value;trim > name && isspace((unsigned char)trim[-1]);)
+         *--trim = '\0';
+      *value++ = '\0';
+      while(value < eol && isspace((unsigned char)*value))
+         ++value;
+
+      // Look up the setting by name
+      for(int i=0;i<sizeof(options)/sizeof(options[0]);++i)
+         if(options[i].config && !strcmp(name, options[i].name))
+         {
+            opt = &options[i];
+            break;
+         }
+      if(opt == NULL)
+      {
+         *error = "Unknown setting";
+         return(-29);
+      }
+
+      // Apply the value, an empty value is invalid
+      if((ret = applyOption(opt, *value?value:NULL, error)))
+         return(ret);
+   }
+
+   return(0);
+}
+
+/*
+ * Parse the comma separated list of bytes sent to the keyboard for caps lock
+ * on, caps lock off, bell, and click. An empty entry sends nothing
+ */
+local bool parseFeedback(char *str)
+{
+   if(str==NULL)
+      return(false);
+
+   // For each feedback event...
+   for(int i=0;i<FEEDBACKS;++i)
+   {
+      char  *end;
+      long  value;
+
+      // If empty entry, no byte is sent for this event...
+      if(*str==',' || *str=='\0')
+         appConfig.feedbackBytes[i] = FEEDBACK_NONE;
+      // Else decimal, octal, or hex byte...
+      else
+      {
+         value = strtol(str, &end, 0);
+         if(end==str || value<0 || value>0xff || (*end!=',' && *end!='\0'))
+            return(false);
+         appConfig.feedbackBytes[i] = (int)value;
+         str = end;
+      }
+
+      // If end of the list...
+      if(*str=='\0')
+         return(true);
+      ++str;
+   }
+
+   // Too many entries
+   return(false);
+}
+
+/*
+ * Parse the comma separated list of keypads on a multi-drop bus,
+ * "<address>[=<key map>]". A keypad without a key map uses the selected key
+ * map with the remap rules applied
+ */
+local bool parseBus(char *str)
+{
+   memset(deviceOf, 0, sizeof(deviceOf));
+   busDevices = 0;
+
+   if(str==NULL)
+      return(false);
+
+   // For each keypad...
+   for(;;)
+   {
+      device_t *device;
+      char     *end;
+      long     address = strtol(str, &end, 0);
+
+      if(end==str || address<0 || address>0xff || deviceOf[address] || busDevices==BUS_DEVICES)
+         return(false);
+      device = &devices[++busDevices];
+      device->address = (int)address;
+      device->map = activeMap;
+
+      // If a key map is given, look it up by name
+      if(*end=='=')
+      {
+         const optionvalue_t  *value;
+         size_t               length = strcspn(++end, ",");
+
+         for(value=keymapValues;value->name;++value)
+            if(length == strlen(value->name) && !strncmp(end, value->name, length))
                break;
-            default:
-               exitApp("Unknown switch", true, -9);
+         if(value->name==NULL)
+            return(false);
+         device->map = keymap[value->value];
+         end += length;
+      }
+      deviceOf[address] = (uint8_t)busDevices;
+
+      // If end of the list...
+      if(*end=='\0')
+         return(true);
+      if(*end!=',')
+         return(false);
+      str = end + 1;
+   }
+}
+
+/*
+ * Copy the selected key map and apply the comma separated remap rules in
+ * order. "<byte>=<key>[+ctrl][+shift][+make|+break]" maps a byte to a key,
+ * sending only its make or break if given, and "<key>:<key>" swaps two keys
+ * wherever they appear in the map. Keys are KEY_ names or codes. The hot
+ * path then uses the single flat table whatever the number of rules
+ */
+local bool compileKeymap(const char *rules)
+{
+   memcpy(activeMap, keymap[appConfig.keymap], sizeof(activeMap));
+
+   // If no rules...
+   if(rules==NULL)
+      return(true);
+
+   // For each rule...
+   for(const char *rule=rules;;++rule)
+   {
+      const char  *end;
+      int         from, to;
+
+      if((end = parseKey(rule, &from)) == NULL)
+         return(false);
+
+      // If mapping a byte to a key...
+      if(*end=='=')
+      {
+         keymap_t entry = {.control = false, .shift = false};
+         bool     single = false;
+
+         if(!isdigit((unsigned char)*rule) || from >= KEYS_PER_MAP ||
+            (end = parseKey(end + 1, &to)) == NULL)
+            return(false);
+         entry.key = (uint16_t)to;
+
+         // Add the modifiers
+         while(*end=='+')
+         {
+            if(!strncmp(end, "+ctrl", 5))
+            {
+               entry.control = true;
+               end += 5;
+            }
+            else if(!strncmp(end, "+shift", 6))
+            {
+               entry.shift = true;
+               end += 6;
+            }
+            // Else if only a make or only a break, once...
+            else if(!single && !strncmp(end, "+make", 5))
+            {
+               single = entry.make = true;
+               end += 5;
+            }
+            else if(!single && !strncmp(end, "+break", 6))
+            {
+               single = true;
+               end += 6;
+            }
+            else
+               return(false);
+         }
+
+         // Without +make or +break, keep the byte's make/break
+         if(single)
+            entry.makebreak = false;
+         else
+         {
+            entry.makebreak = activeMap[from].makebreak;
+            entry.make = activeMap[from].make;
          }
+         activeMap[from] = entry;
+      }
+      // Else if swapping two keys...
+      else if(*end==':')
+      {
+         bool swapped = false;
+
+         if((end = parseKey(end + 1, &to)) == NULL)
+            return(false);
+
+         for(int i=0;i<KEYS_PER_MAP;++i)
+            if(activeMap[i].key == from)
+            {
+               activeMap[i].key = (uint16_t)to;
+               swapped = true;
+            }
+            else if(activeMap[i].key == to)
+            {
+               activeMap[i].key = (uint16_t)from;
+               swapped = true;
+            }
+
+         // If neither key is in the map (control and shift are flags, not
+         // keys), the rule would silently do nothing
+         if(!swapped)
+            return(false);
+      }
+      else
+         return(false);
+
+      // If end of the rules...
+      if(*end=='\0')
+         return(true);
+      if(*end!=',')
+         return(false);
+      rule = end;
+   }
+}
+
+/*
+ * Parse a key name or decimal, octal, or hex code. Returns the end of the
+ * key or NULL if it isn't valid
+ */
+local const char *parseKey(const char *str, int *code)
+{
+   size_t   length = strcspn(str, ",:=+");
+   char     *end;
+
+   // If a code...
+   if(isdigit((unsigned char)*str))
+   {
+      long value = strtol(str, &end, 0);
+
+      if(end != str + length || value < 0 || value > KEY_MAX)
+         return(NULL);
+      *code = (int)value;
+      return(end);
+   }
+
+   // Else look up the name
+   for(const optionvalue_t *name=keyNames;name->name;++name)
+      if(length == strlen(name->name) && !strncmp(str, name->name, length))
+      {
+         *code = name->value;
+         return(str + length);
+      }
+
+   return(NULL);
+}
+
+/*
+ * Display the key map with the remap rules applied, in the remap rule
+ * format
+ */
+local void dumpKeymap(FILE *output)
+{
+   // For each byte...
+   for(int i=0;i<KEYS_PER_MAP;++i)
+   {
+      const char  *name = NULL;
+
+      // Find the name of the key
+      for(const optionvalue_t *key=keyNames;key->name;++key)
+         if(key->value == activeMap[i].key)
+            name = key->name;
+
+      fprintf(output, "0x%02x=", i);
+      if(name)
+         fprintf(output, "%s", name);
+      else
+         fprintf(output, "%d", activeMap[i].key);
+      fprintf(output, "%s%s%s\n", activeMap[i].control?"+ctrl":"", activeMap[i].shift?"+shift":"",
+              activeMap[i].makebreak?"":(activeMap[i].make?"+make":"+break"));
+   }
+
+   fflush(output);
+}
+
+/*
+ * Return the name of a key map
+ */
+local const char *keymapName(int map)
+{
+   for(const optionvalue_t *value=keymapValues;value->name;++value)
+      if(value->value == map)
+         return(value->name);
+   return("custom");
+}
+
+/*
+ * Return the name of a keypad's key map, the selected one if it uses the
+ * key map with the remap rules applied
+ */
+local const char *deviceKeymapName(const device_t *device)
+{
+   if(device->map == activeMap)
+      return(keymapName(appConfig.keymap));
+   return(keymapName((int)((device->map - keymap[0]) / KEYS_PER_MAP)));
+}
+
+// Key events recorded by writeCheck, counted per key code
+local int         checkPressed[KEY_CNT];
+local long        checkEvents;
+
+/*
+ * Send every entry of every key map and the selected map with the remap
+ * rules applied through emitKey() into a recording output. Each entry
+ * must release the modifiers it presses, and an entry with make/break
+ * must release its key. Then measure the throughput of the in-memory
+ * pipeline. Returns the number of problems in the selected map
+ */
+local int checkKeymaps(FILE *output)
+{
+   uint64_t start, time;
+   int      problems;
+
+   writeEvents = writeCheck;
+   appConfig.verbose = false;
+
+   // Check the built-in key maps, then the one used
+   problems = 0;
+   for(int i=0;i<KEYMAPS;++i)
+      problems += checkKeymap(keymap[i], keymapName(i), output);
+   problems += checkKeymap(activeMap, "selected", output);
+
+   // Measure the keys per second mapped and written to the output
+   checkEvents = 0;
+   start = monotonicTime();
+   for(int i=0;i<CHECK_KEYS;++i)
+   {
+      emitKey(-1, &activeMap[i % KEYS_PER_MAP]);
+      if(i % SERIAL_READ_SIZE == SERIAL_READ_SIZE - 1)
+         flushFrame(-1);
+   }
+   flushFrame(-1);
+   time = monotonicTime() - start;
+   fprintf(output, "Throughput - keys: %d events: %ld seconds: %.3f keys/s: %.0f%s\n",
+           CHECK_KEYS, checkEvents, time / 1e9, CHECK_KEYS / (time / 1e9),
+           appConfig.batch?" (batched)":"");
+
+   fflush(output);
+   return(problems);
+}
+
+/*
+ * Check the events emitted for each entry of a key map. Returns the number
+ * of problems found
+ */
+local int checkKeymap(const keymap_t *map, const char *name, FILE *output)
+{
+   int   problems = 0, single[KEY_CNT] = {0};
+
+   // For each byte...
+   for(int i=0;i<KEYS_PER_MAP;++i)
+   {
+      keymap_t key = map[i];
+
+      if(key.key == KEY_RESERVED)
+         continue;
+
+      memset(checkPressed, 0, sizeof(checkPressed));
+      emitKey(-1, &key);
+      flushFrame(-1);
+
+      // The modifiers must be released
+      if(checkPressed[KEY_LEFTCTRL] || checkPressed[KEY_LEFTSHIFT])
+      {
+         fprintf(output, "%s 0x%02x: modifier left pressed\n", name, i);
+         ++problems;
+      }
+      // A make/break key must be released, a single event is balanced
+      // over the whole map
+      if(key.makebreak && checkPressed[key.key])
+      {
+         fprintf(output, "%s 0x%02x: key %d left pressed\n", name, i, key.key);
+         ++problems;
+      }
+      else if(!key.makebreak)
+         single[key.key] += checkPressed[key.key];
+   }
+
+   // Each single event make needs a break in the map
+   for(int i=0;i<KEY_CNT;++i)
+      if(single[i])
+      {
+         fprintf(output, "%s: key %d has %d more %s than %s\n", name, i, abs(single[i]),
+                 single[i] > 0?"makes":"breaks", single[i] > 0?"breaks":"makes");
+         ++problems;
+      }
+
+   fprintf(output, "Key map %s: %s (%d problems)\n", name, problems?"FAIL":"OK", problems);
+   return(problems);
+}
+
+/*
+ * Record the events written instead of writing them to an output
+ */
+local ssize_t writeCheck(int fd, const void *data, size_t size)
+{
+   const struct input_event   *ie = data;
+   size_t                     count = size / sizeof(*ie);
+
+   for(size_t i=0;i<count;++i)
+      if(ie[i].type == EV_KEY && ie[i].code < KEY_CNT)
+         checkPressed[ie[i].code] += ie[i].value?1:-1;
+   checkEvents += (long)count;
+   return((ssize_t)size);
+}
+
+// Events written and read back by the self-test
+local selftest_t        selftest = {.fd = -1};
+
+/*
+ * Create the virtual keyboard and send a stream of bytes through the key
+ * path into it, reading the events back from its evdev node as an
+ * application would. The events must arrive complete and in order. Then
+ * display the time from writing the events to them being readable. Returns
+ * the number of problems found
+ */
+local int runSelftest(FILE *output)
+{
+   unsigned char  mapped[KEYS_PER_MAP], keys[SELFTEST_KEYS];
+   char           path[PATH_MAX];
+   int            count = 0, problems;
+
+   // Send the keys unframed through the selected key map with the remap
+   // rules applied, without the filters that drop keys
+   appConfig.verbose = false;
+   appConfig.errors = ERRORS_IGNORE;
+   appConfig.debounceNs = 0;
+   appConfig.rateIntervalNs = 0;
+   appConfig.quarantineBytes = 0;
+   appConfig.repeatDelayNs = 0;
+   busDevices = 0;
+
+   // Cycle through each mapped byte
+   for(int i=0;i<KEYS_PER_MAP;++i)
+      if(activeMap[i].key != KEY_RESERVED)
+         mapped[count++] = (unsigned char)i;
+   if(count == 0)
+      exitApp("The key map has no keys to send", false, -46);
+   for(int i=0;i<SELFTEST_KEYS;++i)
+      keys[i] = mapped[i % count];
+
+   // Create the virtual keyboard and grab its event device so the keys
+   // don't reach the desktop
+   appConfig.output = OUTPUT_UINPUT;
+   outputFd = connectUinput(NULL);
+   selftest.fd = openEvdev(outputFd, path, sizeof(path));
+   if(ioctl(selftest.fd, EVIOCGRAB, 1) ||
+      ioctl(selftest.fd, EVIOCGBIT(EV_KEY, sizeof(selftest.keybits)), selftest.keybits) < 0)
+      exitApp("Unable to grab the virtual keyboard's event device", false, -46);
+
+   // Send the keys a few at a time, as if read from the serial port
+   writeEvents = writeSelftest;
+   for(int i=0;i<SELFTEST_KEYS;i+=SELFTEST_BATCH)
+      processKeys(&keys[i], (SELFTEST_KEYS - i < SELFTEST_BATCH)?SELFTEST_KEYS - i:SELFTEST_BATCH,
+                  monotonicTime(), outputFd);
+   writeEvents = writeFd;
+   close(selftest.fd);
+
+   problems = (int)(selftest.unexpected + selftest.missing + selftest.dropped);
+   if(stats.keys != SELFTEST_KEYS)
+      ++problems;
+
+   fprintf(output, "Self-test - device: %s keys: %lu events: %lu received: %lu unexpected: %lu missing: %lu dropped: %lu\n",
+           path, stats.keys, selftest.events, selftest.received, selftest.unexpected, selftest.missing, selftest.dropped);
+
+   // Display the write to readable latency percentiles
+   if(selftest.samples)
+   {
+      qsort(selftest.latency, selftest.samples, sizeof(selftest.latency[0]), compareLatency);
+      fprintf(output, "Self-test - write_to_readable_us p50: %.1f p90: %.1f p99: %.1f max: %.1f (%zu writes%s)\n",
+              selftest.latency[selftest.samples * 50 / 100] / 1e3, selftest.latency[selftest.samples * 90 / 100] / 1e3,
+              selftest.latency[selftest.samples * 99 / 100] / 1e3, selftest.latency[selftest.samples - 1] / 1e3,
+              selftest.samples, appConfig.batch?", batched":"");
+   }
+
+   fprintf(output, "Self-test: %s (%d problems)\n", problems?"FAIL":"OK", problems);
+   fflush(output);
+   return(problems);
+}
+
+/*
+ * Find the evdev node the input core created for the virtual keyboard and
+ * open it, waiting for udev to create it. Returns the file descriptor
+ */
+local int openEvdev(int uinputFd, char *path, size_t size)
+{
+   char           name[64], dir[PATH_MAX];
+   DIR            *sys;
+   struct dirent  *entry;
+   int            fd;
+
+   if(ioctl(uinputFd, UI_GET_SYSNAME(sizeof(name)), name) < 0)
+      exitApp("Unable to get the virtual keyboard's name", false, -46);
+   snprintf(dir, sizeof(dir), "/sys/devices/virtual/input/%s", name);
+
+   // Until the event device is found and opened...
+   for(int ms=0;;ms+=SELFTEST_RETRY_MS)
+   {
+      *path = '\0';
+      if((sys = opendir(dir)) != NULL)
+      {
+         while((entry = readdir(sys)) != NULL)
+            if(!strncmp(entry->d_name, "event", 5))
+            {
+               snprintf(path, size, "/dev/input/%s", entry->d_name);
+               break;
+            }
+         closedir(sys);
+      }
+
+      if(*path && (fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC)) != -1)
+         return(fd);
+      if(ms >= SELFTEST_TIMEOUT_MS)
+         exitApp("Unable to open the virtual keyboard's event device", false, -46);
+      usleep(SELFTEST_RETRY_MS * 1000);
+   }
+}
+
+/*
+ * Write the events to uinput, expecting the packets the input core passes
+ * on, then time the event device becoming readable and read them back
+ */
+local ssize_t writeSelftest(int fd, const void *data, size_t size)
+{
+   const struct input_event   *ie = data;
+   uint64_t                   start = monotonicTime();
+   ssize_t                    written = write(fd, data, size);
+
+   // For each event written...
+   for(ssize_t i=0;i<written / (ssize_t)sizeof(*ie);++i)
+      expectEvent(&ie[i]);
+
+   // If packets were passed on, read them back
+   if(selftest.expectedCount)
+   {
+      struct pollfd readable = {.fd = selftest.fd, .events = POLLIN};
+
+      if(poll(&readable, 1, SELFTEST_TIMEOUT_MS) == 1 && selftest.samples < SELFTEST_SAMPLES)
+         selftest.latency[selftest.samples++] = monotonicTime() - start;
+      readSelftest();
+   }
+   return(written);
+}
+
+/*
+ * Add the event to the packet as the input core does. It drops key events
+ * for unregistered keys or that don't change the key's state, and passes
+ * the packet on at SYN_REPORT unless it's empty
+ */
+local void expectEvent(const struct input_event *ie)
+{
+   if(ie->type == EV_KEY)
+   {
+      if(ie->code >= KEY_CNT || !(selftest.keybits[ie->code / 8] & (1 << (ie->code % 8))))
+         return;
+      // Autorepeats pass without changing the state
+      if(ie->value != 2)
+      {
+         if(!(selftest.pressed[ie->code / 8] & (1 << (ie->code % 8))) == (ie->value == 0))
+            return;
+         selftest.pressed[ie->code / 8] ^= (uint8_t)(1 << (ie->code % 8));
+      }
+   }
+   else if(ie->type == EV_SYN && ie->code == SYN_REPORT)
+   {
+      if(selftest.packetCount == 0)
+         return;
+   }
+
+   // If the packet is too long, the check fails as the events are missing
+   if(selftest.packetCount == SELFTEST_EVENTS || selftest.expectedCount + selftest.packetCount >= SELFTEST_EVENTS)
+   {
+      ++selftest.missing;
+      return;
+   }
+   selftest.packet[selftest.packetCount++] = *ie;
+
+   // At the end of the packet, expect it
+   if(ie->type == EV_SYN && ie->code == SYN_REPORT)
+   {
+      memcpy(&selftest.expected[selftest.expectedCount], selftest.packet, selftest.packetCount * sizeof(*ie));
+      selftest.expectedCount += selftest.packetCount;
+      selftest.events += selftest.packetCount;
+      selftest.packetCount = 0;
+   }
+}
+
+/*
+ * Read the expected events back, comparing them in order. Events not read
+ * before the timeout are missing
+ */
+local void readSelftest(void)
+{
+   struct input_event   events[SELFTEST_EVENTS];
+   size_t               next = 0;
+   ssize_t              count;
+
+   // Until every expected event is read...
+   while(next < selftest.expectedCount)
+   {
+      struct pollfd readable = {.fd = selftest.fd, .events = POLLIN};
+
+      if(poll(&readable, 1, SELFTEST_TIMEOUT_MS) != 1 ||
+         (count = read(selftest.fd, events, sizeof(events))) <= 0)
+      {
+         selftest.missing += selftest.expectedCount - next;
+         break;
+      }
+
+      // For each event read...
+      for(ssize_t i=0;i<count / (ssize_t)sizeof(events[0]);++i)
+      {
+         const struct input_event *expected = &selftest.expected[next];
+
+         ++selftest.received;
+         // If the event device's buffer overflowed...
+         if(events[i].type == EV_SYN && events[i].code == SYN_DROPPED)
+         {
+            ++selftest.dropped;
+            continue;
+         }
+         if(next == selftest.expectedCount || events[i].type != expected->type ||
+            events[i].code != expected->code || events[i].value != expected->value)
+            ++selftest.unexpected;
+         if(next < selftest.expectedCount)
+            ++next;
+      }
+   }
+   selftest.expectedCount = 0;
+}
+
+/*
+ * Order latencies for qsort
+ */
+local int compareLatency(const void *a, const void *b)
+{
+   uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+   return((x > y) - (x < y));
+}
+
+/*
+ * Parse the output name and path, "name" or "name:path"
+ */
+local bool parseOutput(char *str)
+{
+   if(str==NULL)
+      return(false);
+
+   char     *path = strchr(str, ':');
+   size_t   length = path?(size_t)(path - str):strlen(str);
+
+   // For each output backend...
+   for(int i=0;i<OUTPUTS;++i)
+   {
+      // If the name matches...
+      if(strlen(outputs[i].name) == length && !strncmp(str, outputs[i].name, length))
+      {
+         // If a path is required but not provided or vice versa...
+         if(outputs[i].path != (path && path[1]))
+            return(false);
+         appConfig.output = (outputs_t)i;
+         appConfig.outputPath = path?path+1:NULL;
+         return(true);
+      }
+   }
+
+   return(false);
+}
+
+/*
+ * Parse the metrics exporter, socket:<path> or file:<path>
+ */
+local bool parseMetrics(char *str)
+{
+   if(str==NULL)
+      return(false);
+
+   if(!strncmp(str, "socket:", 7) && str[7])
+      appConfig.metrics = METRICS_SOCKET;
+   else if(!strncmp(str, "file:", 5) && str[5])
+      appConfig.metrics = METRICS_FILE;
+   else
+      return(false);
+
+   appConfig.metricsPath = strchr(str, ':') + 1;
+   return(true);
+}
+
+/*
+ * Display the application usage w/command line options and exit w/error
+ */
+local void displayUsage(FILE *output_stream)
+{
+   fprintf(output_stream, "Usage: serkey [OPTION]... serial_device\n\n\r"
+          "serkey is a user mode serial keyboard driver for Linux. It utilizes the uinput\n\r"
+          "kernel module and tio serial device I/O tool. Therefore, both must be installed\n\r"
+          "and enabled. In addition, serkey must be run at a priviledge level capable of\n\r"
+          "communicating with uinput. On most distributions, this is root level priviledges\n\r"
+          "by default. The serial_device specifies the \\dev tty device connected to the \n\r"
+          "keyboard.\n\n\r"
+          "OPTIONS:\n\r"
+          "  -b, --baud <bps>\n\r"
+          "       Set the baud rate in bits per second (bps) (default:300)\n\r"
+          "  -p, --parity odd|even|none\n\r"
+          "       Set the parity  (default:none)\n\r"
+          "  -d, --data_bits 5|6|7|8\n\r"
+          "       Set the number of data bits (default:8)\n\r"
+          "  -s, --stop_bits 1|2\n\r"
+          "       Set the number of stop bits (default:1)\n\r"
+          "  -k, --key_map kaypro|media_keys|ascii\n\r"
+          "       Select the key mapping (default:kaypro)\n\r"
+          "  -l, --feedback <caps_on>,<caps_off>,<bell>,<click>\n\r"
+          "       Send LED and bell feedback bytes to the keyboard (default:none)\n\r"
+          "  -e, --errors ignore|count|drop\n\r"
+          "       Mark parity, framing, and break errors and count or drop the\n\r"
+          "       bytes. Send SIGUSR1 to display the counts (default:ignore)\n\r"
+          "  -o, --output uinput|stdout|file:<path>|socket:<path>\n\r"
+          "       Write the key events to uinput, or as a binary input_event\n\r"
+          "       stream to stdout, a file, or a Unix socket (default:uinput)\n\r"
+          "  -L, --loop epoll|uring\n\r"
+          "       Select the event loop. uring falls back to epoll if io_uring\n\r"
+          "       isn't available (default:epoll)\n\r"
+          "  -T, --threads\n\r"
+          "       Read the serial port in a separate thread from the one that\n\r"
+          "       writes to the output\n\r"
+          "  -a, --bus <address>[=<key map>][,<address>[=<key map>]]...\n\r"
+          "       Receive DLE STX <address> <key>... DLE ETX frames from keypads on\n\r"
+          "       a multi-drop bus, mapping each address's keys with its key map\n\r"
+          "  -m, --remap <rule>[,<rule>]...\n\r"
+          "       Remap the key map. <byte>=<key>[+ctrl][+shift][+make|+break] maps\n\r"
+          "       a byte and <key>:<key> swaps two keys. Keys are KEY_ names or codes\n\r"
+          "      --dump_keymap\n\r"
+          "       Display the key map with the remap rules applied and exit\n\r"
+          "      --check_keymap\n\r"
+          "       Check the key maps balance their make, break, and modifier events,\n\r"
+          "       measure the keys per second mapped, and exit\n\r"
+          "      --selftest\n\r"
+          "       Send keys through a virtual keyboard, check its event device\n\r"
+          "       receives them in order, measure the latency, and exit\n\r"
+          "  -D, --debounce <ms>\n\r"
+          "       Drop a repeat of the same byte within the window (default:0, off)\n\r"
+          "  -R, --rate_limit <keys/s>[,<burst>]\n\r"
+          "       Drop keys a keypad sends faster than the rate once a burst of\n\r"
+          "       keys is spent (default:0, off. burst default:keys/s)\n\r"
+          "  -Q, --quarantine <bytes/s>\n\r"
+          "       Ignore a keypad sending more unmapped or rate limited bytes per\n\r"
+          "       second, for 1 second doubling to 64 if it repeats (default:0, off)\n\r"
+          "  -A, --autorepeat <delay ms>[,<rate/s>]\n\r"
+          "       Repeat the last key made while it's held, for keypads sending a\n\r"
+          "       make and a break mapped with +make and +break (default:0, off.\n\r"
+          "       rate default:30)\n\r"
+          "  -K, --key_counts csv|json\n\r"
+          "       Format of the per-key counts displayed on SIGUSR2 (default:csv)\n\r"
+          "  -O, --overflow drop|exit\n\r"
+          "       When the output stops accepting events and the pending queue is\n\r"
+          "       full, drop the new events or exit (default:drop)\n\r"
+          "  -H, --flow_control\n\r"
+          "       Use RTS/CTS flow control, and deassert RTS while the output is behind\n\r");
+   // Split to stay under the string length compilers must support
+   fprintf(output_stream,
+          "  -B, --batch\n\r"
+          "       Write the events for all the keys read at once in a single write\n\r"
+          "  -r, --rt_priority <1-99>\n\r"
+          "       Run the event loop at a SCHED_FIFO real-time priority\n\r"
+          "  -u, --user <user>[:<group>]\n\r"
+          "       Drop to the user and group after opening the devices\n\r"
+          "  -U, --upgrade <path>\n\r"
+          "       Take over the devices of the serkey listening on the socket, and\n\r"
+          "       listen on it to hand them to the next serkey when upgrading\n\r"
+          "  -P, --stats_page <path>\n\r"
+          "       Publish the counters and a latency histogram in a shared memory\n\r"
+          "       file monitors can read without system calls\n\r"
+          "  -M, --metrics socket:<path>|file:<path>\n\r"
+          "       Export Prometheus metrics to each connection to a Unix socket, or\n\r"
+          "       to a file for the node_exporter textfile collector\n\r"
+          "  -z, --seccomp\n\r"
+          "       Restrict the system calls to those the event loop needs\n\r"
+          "      --profile\n\r"
+          "       Count the cycles, instructions, cache misses, and context\n\r"
+          "       switches of each key, displayed on exit and with SIGUSR1\n\r"
+          "  -c, --config <file>\n\r"
+          "       Load the settings from the file instead of " CONFIG_FILE "\n\r"
+          "       Command line options override the file\n\r"
+          "  -f, --fork\n\r"
+          "       Fork and exit creating daemon process\n\r"
+          "  -v, --verbose\n\r"
+          "       Verbose output to stdout/stderr\n\r"
+          "  -h, --help\n\r"
+          "       Display this usage information\n\r");
+}
+
+/*
+ * Display a message and exit the application with a given return code
+ */
+local void exitApp(char* error_str, bool display_usage, int return_code)
+{
+   persistent bool   exiting = false;
+   FILE              *output;
+   int               error = errno;
+
+   PROBE(exit, return_code, error, error_str);
+
+   // If not already exiting (cleanup can fail and exit again)...
+   if(!exiting)
+   {
+      exiting = true;
+
+      // Finish the io_uring writes, then write pending events, release
+      // held keys, and remove the output
+      stopUring();
+      disconnectOutput();
+
+      // If the serial port has already been configured, restore it...
+      if(ttyFd>0)
+         closeSerial(ttyFd);
+
+      // If listening for an upgrade, remove the socket
+      if(upgradeFd != -1)
+         unlink(appConfig.upgradePath);
+
+      // Publish the final stats and mark the page as no longer updated
+      closeStatsPage();
+
+      // If serving metrics, remove the socket, or the temporary file if
+      // writing them
+      if(metricsFd != -1)
+         unlink(appConfig.metricsPath);
+      if(metricsDirFd != -1)
+         unlinkat(metricsDirFd, metricsTemp, 0);
+
+      // If profiling, display the cost of the keys
+      if(profile.fd != -1)
+         dumpProfile(stdout);
+   }
+   // If cleanup failed before the serial port was restored, still restore it
+   else if(ttyFd>0)
+      closeSerial(ttyFd);
+   errno = error;
+
+   // Is the return code an error...
+   if(return_code)
+      output = stderr;
+   else
+      output = stdout;
+
+   // If an error string was provided...
+   if(error_str)
+      if(strlen(error_str))
+         fprintf(output, "%s %s\n\r%s %s\n\r",  return_code?"Error:":"OK:", 
+                                       error_str, 
+                                       return_code?"Error Code -":"", 
+                                       return_code?strerror(errno):"");
+
+   if(display_usage == true)
+      displayUsage(output);
+
+   fflush(output);
+   exit(return_code);
+}
+
+// Uinput interface functions *************************************************
+/*
+ * Emit an event to the output
+ */
+local void emit(int fd, int type, int code, int val)
+{
+   struct input_event ie;
+
+   ie.type = type;
+   ie.code = code;
+   ie.value = val;
+   // timestamp values below are ignored
+   ie.time.tv_sec = 0;
+   ie.time.tv_usec = 0;
+
+   PROBE(emit, type, code, val);
+
+   // Track the keys that are made so they can be released on exit
+   if(type == EV_KEY && code >= 0 && code < KEY_CNT)
+   {
+      if(val)
+         heldKeys[code / 8] |= (uint8_t)(1 << (code % 8));
+      else
+         heldKeys[code / 8] &= (uint8_t)~(1 << (code % 8));
+
+      // If autorepeating, the last key made repeats until it's broken. Its
+      // first repeat is scheduled once the keys read are written, so a key
+      // made and broken together costs nothing
+      if(appConfig.repeatDelayNs)
+      {
+         if(val == 1 && !isModifier(code))
+         {
+            repeat.key = code;
+            repeat.next = 0;
+         }
+         else if(val == 0 && code == repeat.key)
+            repeat.key = KEY_RESERVED;
+      }
+   }
+
+   // If batching, add the event to the frame written after the read...
+   if(appConfig.batch)
+   {
+      frame[frameCount++] = ie;
+      if(frameCount == FRAME_EVENTS)
+         flushFrame(fd);
+      return;
+   }
+
+   writeOutput(fd, &ie, sizeof(ie));
+}
+
+/*
+ * Write the batched events to the output in a single write
+ */
+local void flushFrame(int fd)
+{
+   // If no events are batched...
+   if(frameCount == 0)
+      return;
+
+   writeOutput(fd, frame, frameCount * sizeof(frame[0]));
+   frameCount = 0;
+}
+
+/*
+ * Emit a key press to the output
+ */
+local void emitKey(int fd, keymap_t *key)
+{
+
+   LOG("  Out - ");
+   
+   // If control key required...
+   if(key->control)
+   {
+      LOG("Ctrl: Make ");
+      // Control key make, report the event
+      emit(fd, EV_KEY, KEY_LEFTCTRL, 1);
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+   }
+   else
+      LOG("Ctrl: N/A  ");
+   // If shift key required...
+   if(key->shift)
+   {
+      LOG("Shift: Make ");
+      // Shift key make, report the event
+      emit(fd, EV_KEY, KEY_LEFTSHIFT, 1);
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+   }
+   else
+      LOG("Shift: N/A  ");
+
+   // If make/break required...
+   if(key->makebreak)
+   {
+      LOG("MB: 1 Key %03d ",key->key);
+      // Key make, report the event
+      emit(fd, EV_KEY, key->key, 1);
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+      // Key break, report the event
+      emit(fd, EV_KEY, key->key, 0);
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+   }
+   // Else just make or break...
+   else
+   {
+      LOG("MB: 0 Key %03d %s ",key->key, key->make?"make":"break");
+      // Key make or break, report the event
+      emit(fd, EV_KEY, key->key, key->make);
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+   }
+
+   // If control key required...
+   if(key->control)
+   {
+      LOG("CTRL: break");
+      // Control key break, report the event
+      emit(fd, EV_KEY, KEY_LEFTCTRL, 0);
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+   }
+   // If shift key required...
+   if(key->shift)
+   {
+      LOG("SHIFT: break");
+      // Shift key break, report the event
+      emit(fd, EV_KEY, KEY_LEFTSHIFT, 0);
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+   }
+
+   LOG("\n\r");
+}
+
+/*
+ * Connect to the uinput kernel module
+ */
+local int connectUinput(char *path)
+{
+   (void)path;
+
+   /*
+    * uinput setup and open a pipe to uinput
+    */
+   struct uinput_setup usetup;
+   int fd = open("/dev/uinput", O_RDWR | O_NONBLOCK);
+
+   // If unable to open a pipe to uinput...
+   if(fd == -1)
+   {
+      exitApp("Unable to open pipe to uinput. Make sure you have permission to access\n\r"
+              "uinput virtual device. Try \"sudo serkey\" to run at root level permissions"
+              , false, -17);
+   }
+
+   /*
+    * The ioctls below will enable the device that is about to be
+    * created. This includes "registering" all the possible key events
+    */
+   ioctl(fd, UI_SET_EVBIT, EV_KEY);
+   // EV_REP isn't registered, so the input core never autorepeats and the
+   // repeats sent with --autorepeat aren't doubled
+   for(int i=0;i<256;++i)
+   {
+      // Register the keys of every keypad's key map
+      for(int j=0;j<=busDevices;++j)
+         if(devices[j].map[i].key != KEY_RESERVED)
+            ioctl(fd, UI_SET_KEYBIT, devices[j].map[i].key);
+
+      ioctl(fd,UI_SET_KEYBIT,KEY_LEFTSHIFT);
+      ioctl(fd,UI_SET_KEYBIT,KEY_LEFTCTRL);
+   }
+
+   // If feedback is enabled, register the LEDs and sounds the keyboard can
+   // be sent. uinput returns these events to us when applications set them
+   if(appConfig.feedback)
+   {
+      ioctl(fd, UI_SET_EVBIT, EV_LED);
+      ioctl(fd, UI_SET_LEDBIT, LED_CAPSL);
+      ioctl(fd, UI_SET_EVBIT, EV_SND);
+      ioctl(fd, UI_SET_SNDBIT, SND_BELL);
+      ioctl(fd, UI_SET_SNDBIT, SND_CLICK);
+   }
+
+   memset(&usetup, 0, sizeof(usetup));
+   usetup.id.bustype = BUS_USB;
+   usetup.id.vendor = 0x1234; /* sample vendor */
+   usetup.id.product = 0x5678; /* sample product */
+   strncpy(usetup.name, "serkey", sizeof(usetup.name));
+
+   ioctl(fd, UI_DEV_SETUP, &usetup);
+   ioctl(fd, UI_DEV_CREATE);
+
+   return(fd);
+}
+
+/*
+ * Destroy the uinput virtual keyboard and close uinput
+ */
+local void disconnectUinput(int fd)
+{
+   ioctl(fd, UI_DEV_DESTROY);
+   close(fd);
+}
+
+/*
+ * Break every key that is still made so applications don't see it stuck
+ */
+local void releaseKeys(int fd)
+{
+   bool released = false;
+
+   // For each key that is made...
+   for(int i=0;i<KEY_CNT;++i)
+   {
+      if(heldKeys[i / 8] & (1 << (i % 8)))
+      {
+         LOG("Releasing key %03d\n\r", i);
+         emit(fd, EV_KEY, i, 0);
+         released = true;
+      }
+   }
+
+   // If any keys were released, report the events
+   if(released)
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+}
+
+/*
+ * Read the LED and sound events uinput returns and queue the matching
+ * feedback bytes to the keyboard. A socket can return part of an event,
+ * which is kept until the rest arrives
+ */
+local void readUinput(int fd, int serialFd)
+{
+   persistent unsigned char   partial[sizeof(struct input_event)];
+   persistent size_t          length = 0;
+   struct input_event         ie;
+   ssize_t                    count;
+   int                        feedback;
+
+   // For each pending event...
+   while((count = read(fd, partial + length, sizeof(partial) - length)) > 0)
+   {
+      // If only part of the event has arrived, wait for the rest
+      if((length += (size_t)count) < sizeof(partial))
+         continue;
+      memcpy(&ie, partial, sizeof(ie));
+      length = 0;
+
+      // Translate the event to a feedback byte
+      if(ie.type == EV_LED && ie.code == LED_CAPSL)
+         feedback = ie.value?FEEDBACK_CAPS_ON:FEEDBACK_CAPS_OFF;
+      else if(ie.type == EV_SND && ie.code == SND_BELL && ie.value)
+         feedback = FEEDBACK_BELL;
+      else if(ie.type == EV_SND && ie.code == SND_CLICK && ie.value)
+         feedback = FEEDBACK_CLICK;
+      else
+         continue;
+
+      LOG(" Feedback - event: %d code: %d value: %d\n\r", ie.type, ie.code, ie.value);
+
+      // If a byte is configured for this event...
+      if(appConfig.feedbackBytes[feedback] != FEEDBACK_NONE)
+         queueSerial(serialFd, (unsigned char)appConfig.feedbackBytes[feedback]);
+   }
+
+   // If the consumer closed the socket or the output failed, the keys can't
+   // be delivered either. Exit rather than poll the hung up output forever
+   if(count == 0)
+   {
+      errno = EPIPE;
+      exitApp("The output closed", false, -12);
+   }
+   if(errno != EAGAIN && errno != EINTR)
+      exitApp("Unable to read feedback from the output", false, -12);
+}
+
+// Output Backend Functions ***************************************************
+/*
+ * Connect to the output selected on the command line and set the write
+ * function used on the key path
+ */
+local int connectOutput(void)
+{
+   output_t *output = &outputs[appConfig.output];
+
+   writeEvents = output->write;
+   return(output->connect(appConfig.outputPath));
+}
+
+/*
+ * Write the pending events, release the held keys, and remove the output
+ */
+local void disconnectOutput(void)
+{
+   int fd = outputFd;
+
+   // If the output isn't connected...
+   if(fd == -1)
+      return;
+
+   flushFrame(fd);
+   releaseKeys(fd);
+   flushFrame(fd);
+   drainPending(fd);
+
+   outputFd = -1;
+   outputs[appConfig.output].disconnect(fd);
+}
+
+/*
+ * Close a stdout, file, or socket output
+ */
+local void disconnectFd(int fd)
+{
+   // Don't close stdout, exit flushes it
+   if(fd != STDOUT_FILENO)
+      close(fd);
+}
+
+/*
+ * Write the event stream to stdout
+ */
+local int connectStdout(char *path)
+{
+   (void)path;
+   return(STDOUT_FILENO);
+}
+
+/*
+ * Create/truncate a file and write the event stream to it
+ */
+local int connectFile(char *path)
+{
+   int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+   if(fd == -1)
+      exitApp("Unable to open the output file", false, -24);
+
+   return(fd);
+}
+
+/*
+ * Connect to a listening Unix socket and write the event stream to it. The
+ * consumer can send LED and sound events back over the same socket
+ */
+local int connectSocket(char *path)
+{
+   struct sockaddr_un   addr;
+   int                  fd;
+
+   if(strlen(path) >= sizeof(addr.sun_path))
+      exitApp("Output socket path is too long", false, -25);
+
+   if((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1)
+      exitApp("Unable to create the output socket", false, -25);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+
+   if(connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+      exitApp("Unable to connect to the output socket", false, -25);
+
+   // Don't block the event loop reading feedback
+   fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+   return(fd);
+}
+
+/*
+ * Write events to a uinput, stdout, or file descriptor
+ */
+local ssize_t writeFd(int fd, const void *data, size_t size)
+{
+   return(write(fd, data, size));
+}
+
+/*
+ * Write events to a socket without raising SIGPIPE if the consumer is gone
+ */
+local ssize_t writeSocket(int fd, const void *data, size_t size)
+{
+   return(send(fd, data, size, MSG_NOSIGNAL));
+}
+
+/*
+ * Write events to the output. If the output doesn't accept them all, queue
+ * the rest and write them in order when the output is writable
+ */
+local void writeOutput(int fd, const void *data, size_t size)
+{
+   ssize_t ret = 0;
+
+   // If nothing is queued, write directly
+   if(pending.end == pending.start)
+   {
+      ret = writeEvents(fd, data, size);
+      PROBE(write, size / sizeof(struct input_event), ret);
+
+      // If all the events were written...
+      if(ret == (ssize_t)size)
+         return;
+      if(ret < 0 && errno != EAGAIN)
+         exitApp("Failed to write to output\n\r", false, -12);
+      if(ret < 0)
+         ret = 0;
+   }
+
+   // If the output just stopped accepting events, wait for it to be
+   // writable. Without the epoll loop, drainPending() waits on exit
+   if(queuePending((const unsigned char *)data + ret, size - (size_t)ret) && pending.stallStart == 0)
+   {
+      pending.stallStart = monotonicTime();
+      ++pending.stalls;
+      if(epollFd != -1)
+         watchEvents(fd, outputEvents | EPOLLOUT, outputEvents?EPOLL_CTL_MOD:EPOLL_CTL_ADD);
+   }
+}
+
+/*
+ * Add events to the pending queue. If it's full, apply the overflow policy.
+ * Returns true if any events are queued
+ */
+local bool queuePending(const unsigned char *data, size_t size)
+{
+   // If the queue doesn't have room at the end, move the events to the front
+   if(pending.end + size > sizeof(pending.data))
+   {
+      memmove(pending.data, pending.data + pending.start, pending.end - pending.start);
+      pending.end -= pending.start;
+      pending.start = 0;
+   }
+
+   // If the queue is full...
+   if(pending.end + size > sizeof(pending.data))
+   {
+      const struct input_event   *ie = (const struct input_event *)data;
+      size_t                     count = size / sizeof(*ie);
+
+      if(appConfig.overflow == OVERFLOW_EXIT)
+         exitApp("The output stopped accepting events\n\r", false, -12);
+
+      // Drop the events, remembering the releases so the keys aren't left
+      // pressed. Only a direct write, made with the queue empty, can end
+      // partway through an event, so dropped events are always whole
+      for(size_t i=0;i<count;++i)
+         if(ie[i].type == EV_KEY && ie[i].value == 0 && ie[i].code < KEY_CNT)
+         {
+            pending.lostReleases[ie[i].code / 8] |= (uint8_t)(1 << (ie[i].code % 8));
+            pending.lost = true;
+         }
+      pending.dropped += count;
+      return(pending.end != pending.start);
+   }
+
+   memcpy(pending.data + pending.end, data, size);
+   pending.end += size;
+   if(pending.end - pending.start > pending.highWater)
+      pending.highWater = pending.end - pending.start;
+
+   // If the queue is filling, stop the sender
+   if(pending.end - pending.start >= OUTPUT_HIGH_WATER * sizeof(struct input_event))
+      throttleSerial(true);
+
+   return(true);
+}
+
+/*
+ * Write the pending events the output accepts. Once they're all written,
+ * release the keys whose release was dropped and stop waiting for the
+ * output
+ */
+local void flushPending(int fd)
+{
+   ssize_t  ret;
+   uint64_t stall;
+
+   // If nothing is queued...
+   if(pending.end == pending.start)
+      return;
+
+   ret = writeEvents(fd, pending.data + pending.start, pending.end - pending.start);
+   PROBE(write, (pending.end - pending.start) / sizeof(struct input_event), ret);
+   if(ret < 0 && errno != EAGAIN)
+      exitApp("Failed to write to output\n\r", false, -12);
+   if(ret > 0)
+      pending.start += (size_t)ret;
+
+   // If the queue has drained, let the sender continue
+   if(pending.end - pending.start <= OUTPUT_LOW_WATER * sizeof(struct input_event))
+      throttleSerial(false);
+
+   // If events are still queued, wait for the output again
+   if(pending.end != pending.start)
+      return;
+   pending.start = pending.end = 0;
+
+   stall = monotonicTime() - pending.stallStart;
+   pending.stallTotal += stall;
+   if(stall > pending.stallMax)
+      pending.stallMax = stall;
+   pending.stallStart = 0;
+   if(epollFd != -1)
+      watchEvents(fd, outputEvents, outputEvents?EPOLL_CTL_MOD:EPOLL_CTL_DEL);
+
+   // If releases were dropped, release the keys now
+   if(pending.lost)
+   {
+      pending.lost = false;
+      for(int i=0;i<KEY_CNT;++i)
+         if(pending.lostReleases[i / 8] & (1 << (i % 8)))
+         {
+            LOG("Releasing key %03d\n\r", i);
+            emit(fd, EV_KEY, i, 0);
+         }
+      memset(pending.lostReleases, 0, sizeof(pending.lostReleases));
+      emit(fd, EV_SYN, SYN_REPORT, 0);
+      flushFrame(fd);
+   }
+}
+
+/*
+ * Write the pending events before exiting, waiting a short time for the
+ * output to accept them
+ */
+local void drainPending(int fd)
+{
+   struct pollfd ready = {.fd = fd, .events = POLLOUT};
+
+   while(pending.end != pending.start && poll(&ready, 1, OUTPUT_DRAIN_MS) > 0)
+      flushPending(fd);
+}
+
+// Serial Port Functions ******************************************************
+/*
+ * Get the current serial configuration
+ */
+local int getSerialConfig( int fd,                 // File descriptor
+                           struct termios *config) // termios configuration
+{
+   int ret = tcgetattr(fd,config);
+   return(ret);
+}
+
+/*
+ * Set the current serial configuration
+ */
+local int setSerialConfig( int fd,                 // File descriptor
+                           struct termios *config) // termios configuration
+{
+   int ret = tcsetattr(fd,TCSANOW,config);
+   return(ret);
+}
+
+/*
+ * Setup the serial port
+ */
+local int configSerial( int         fd,         // File descriptor for /dev/tty?
+                        speed_t     speed,      // Baudrate B? [B50 to B115200]
+                        parity_t    parity,     // Parity [PARITY_NONE | PARITY_ODD | PARITY_EVEN]
+                        databits_t  dataBits,   // Number of data bits [DATABITS_5 | DATABITS_6 | DATABITS_7 | DATABITS_8]
+                        stopbits_t  stopBits,   // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+                        errors_t    errors,     // Serial error handling [ERRORS_IGNORE | ERRORS_COUNT | ERRORS_DROP]
+                        bool        flowControl)// RTS/CTS hardware flow control
+{
+   struct termios tty;
+
+   // Start from a clean configuration so no stale flags are inherited
+   memset(&tty, 0, sizeof(tty));
+
+   // Set the input and output baudrate
+   cfsetospeed(&tty, speed);
+   cfsetispeed(&tty, speed);
+
+   // Set the data bits
+   tty.c_cflag &= ~CSIZE;
+   tty.c_cflag |= dataBits;
+
+   // Disable Ignore CR and CR/NL translations
+   tty.c_iflag &= ~(INLCR | IGNCR | ICRNL | ISTRIP); // disable break processing
+   tty.c_lflag = 0;        // no signaling chars, no echo,
+                           // no canonical processing
+   tty.c_oflag = 0;        // no remapping, no delays
+
+   // Block until 1 character read
+   tty.c_cc[VMIN]  = 1;
+   tty.c_cc[VTIME] = 0;
+
+   // Turn off xon/xoff ctrl
+   tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+   // Ignore modem ctrls and enable read
+   tty.c_cflag |= (CLOCAL | CREAD);    
+   // If enabled, turn on rts/cts so the driver deasserts RTS when its
+   // buffer fills and only transmits while CTS is asserted
+   if(flowControl)
+      tty.c_cflag |= CRTSCTS;
+
+   // Set parity
+   tty.c_cflag &= ~(PARENB | PARODD);
+   if(parity == PARITY_ODD)
+      tty.c_cflag |= (PARENB | PARODD);
+   else if(parity == PARITY_EVEN)
+      tty.c_cflag |= PARENB;
+
+   // Set stop bits
+   tty.c_cflag &= ~CSTOPB;
+   tty.c_cflag |= (unsigned int)stopBits;
+
+   // If marking errors, check parity and mark errored bytes and breaks
+   // in-band as \377 \0 <byte>. A literal \377 is received as \377 \377
+   tty.c_iflag &= ~(INPCK | PARMRK | IGNPAR | IGNBRK | BRKINT);
+   if(errors != ERRORS_IGNORE)
+      tty.c_iflag |= (INPCK | PARMRK);
+
+   return(setSerialConfig(fd, &tty));
+}
+
+/*
+ * Open a tty serial device, save it's current config, and set the new config
+ */
+local int openSerial(char *tty,              // Path/Name of the tty device
+                     speed_t     speed,      // Baudrate B? [B50 to B115200]
+                     parity_t    parity,     // Parity [PARITY_NONE | PARITY_ODD | PARITY_EVEN]
+                     databits_t  dataBits,   // Number of data bits [DATABITS_5 | DATABITS_6 | DATABITS_7 | DATABITS_8]
+                     stopbits_t  stopBits,   // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+                     errors_t    errors,     // Serial error handling [ERRORS_IGNORE | ERRORS_COUNT | ERRORS_DROP]
+                     bool        flowControl)// RTS/CTS hardware flow control
+{
+   int fd;
+
+   // Open the file descriptor
+   if((fd = open(tty, O_RDWR | O_NOCTTY | O_NONBLOCK))<0)
+      exitApp("Unable to open to serial device",false,-1);
+
+   // Get the current serial device configuration
+   if(getSerialConfig(fd,&ttyConfig))
+      exitApp("Unable to get the current serial device configuration",false,-1);
+
+   // Setup the new serial device configuration
+   if(configSerial(fd, speed, parity, dataBits, stopBits, errors, flowControl))
+      exitApp("Unable to set the serial device configuration",false,-1);
+
+   return(fd);
+}
+
+/*
+ * Deassert RTS to stop the sender while the output is behind, or reassert
+ * it once the output has caught up. Only used with RTS/CTS flow control
+ */
+local void throttleSerial(bool throttle)
+{
+   persistent bool   throttled = false;
+   int               rts = TIOCM_RTS;
+
+   // If flow control is off or RTS is already set...
+   if(!appConfig.flowControl || throttle == throttled || ttyFd <= 0)
+      return;
+
+   // Not every tty has modem lines, a failure leaves RTS to the driver
+   if(ioctl(ttyFd, throttle?TIOCMBIC:TIOCMBIS, &rts) == 0)
+   {
+      throttled = throttle;
+      if(throttle)
+         ++stats.throttles;
+      LOG("%s RTS\n\r", throttle?"Deasserted":"Asserted");
+   }
+}
+
+/*
+ * Close a tty serial device and restore it's config
+ */
+local int closeSerial(int fd)    // File descriptor of serial device
+{
+   // Don't leave the sender stopped
+   throttleSerial(false);
+   ttyFd = 0;
+   if(setSerialConfig(fd,&ttyConfig))
+      exitApp("Unable to reset the serial device configuration",false,-1);
+   return(close(fd));
+}
+
+/*
+ * Read the available keys from the serial port and send them to uinput
+ */
+local void readSerial(int fd, int uinputFd)
+{
+   unsigned char  keys[SERIAL_READ_SIZE];
+   ssize_t        count;
+
+   // Read the available keys from the serial port, timestamping them
+   // before the tty layer coalesces any more
+   count = read(fd, keys, sizeof(keys));
+
+   processKeys(keys, count, monotonicTime(), uinputFd);
+}
+
+/*
+ * Map the keys read from the serial port and send them to uinput. A count
+ * of zero or less is the result of a failed read
+ */
+local void processKeys(unsigned char *keys, ssize_t count, uint64_t time, int uinputFd)
+{
+   unsigned long accepted = stats.keys;
+
+   // If read returned an error or zero bytes...
+   if(count<0)
+   {
+      if(errno==EAGAIN || errno==EINTR)
+         return;
+      exitApp("read returned an error", false, -2);
+   }
+   else if(count==0)
+      exitApp("read returned zero bytes", false, 0);
+
+   // If profiling, count from decoding the keys to writing their events
+   if(profile.fd != -1)
+      readCounters(profile.start);
+
+   // For each key read from the serial port...
+   for(ssize_t i=0;i<count;++i)
+      processKey(keys[i], time, uinputFd);
+
+   // Write the events batched for the keys read
+   flushFrame(uinputFd);
+   if(profile.fd != -1)
+      endProfile(stats.keys - accepted);
+
+   // If a key was made to autorepeat, schedule its first repeat
+   if(repeat.key != KEY_RESERVED && repeat.next == 0)
+      startRepeat(time);
+
+   // If publishing stats or metrics, count the keys' latency and update
+   // the stats page
+   if(measureLatency)
+   {
+      uint64_t now = monotonicTime();
+
+      recordLatency(now, time, stats.keys - accepted);
+      if(statsPage)
+         publishStats(now);
+   }
+}
+
+/*
+ * Map a key read from the serial port and send it to uinput
+ */
+local void processKey(unsigned char key, uint64_t time, int uinputFd)
+{
+   device_t *device = &devices[0];
+
+   PROBE(byte, key);
+
+   // If marking errors, strip the marks and skip dropped bytes
+   if(appConfig.errors != ERRORS_IGNORE && !unmarkSerial(&key))
+      return;
+
+   // If on a multi-drop bus, strip the framing and find the keypad that
+   // sent the key
+   if(busDevices && (device = deframeSerial(key)) == NULL)
+      return;
+
+   // If the keypad is quarantined, drop its bytes until the quarantine ends
+   if(time < device->quarantineEnd)
+   {
+      ++device->quarantined;
+      return;
+   }
+
+   // If debouncing, suppress a repeat of the byte within the window of the
+   // last one accepted, it's a worn keyswitch chattering
+   if(appConfig.debounceNs)
+   {
+      if(device->lastSeen[key] && time - device->lastSeen[key] < appConfig.debounceNs)
+      {
+         ++stats.suppressed;
+         LOG(" In - Key code: %03d suppressed\n\r", key);
+         return;
+      }
+      device->lastSeen[key] = time;
+   }
+
+   // If rate limiting, drop the key if the keypad is further ahead of the
+   // rate than the burst allows. The budget is the time the next key is due,
+   // so it takes no timer to refill
+   if(appConfig.rateIntervalNs)
+   {
+      if(device->nextKey < time)
+         device->nextKey = time;
+      if(device->nextKey - time > appConfig.rateBurstNs)
+      {
+         ++device->limited;
+         LOG(" In - Key code: %03d rate limited\n\r", key);
+         countBadByte(device, time);
+         return;
+      }
+      device->nextKey += appConfig.rateIntervalNs;
+   }
+   ++stats.keys;
+   ++device->keys;
+
+   // If the byte isn't mapped, it may be a faulty keypad
+   if(device->map[key].key == KEY_RESERVED)
+   {
+      ++device->unmapped;
+      countBadByte(device, time);
+   }
+
+   // Count the byte for its keypad. The event loop is the only writer, so a
+   // relaxed load and store avoids a locked add and readers never see a
+   // torn count
+   __atomic_store_n(&device->keyCounts[key], __atomic_load_n(&device->keyCounts[key], __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+
+   // Display it to stdout
+   if(isprint(key))
+      LOG(" In - Key: \"%c\" code: %03d ", (char)key, key);
+   else
+      LOG(" In - Key: N/A code: %03d ", key);
+
+   // Send the mapped key code to uinput
+   PROBE(keymap, key, device->address, device->map[key].key);
+   emitKey(uinputFd, &device->map[key]);
+}
+
+/*
+ * Count an unmapped or rate limited byte from a keypad, and quarantine the
+ * keypad if it sends more than the threshold in a second. A keypad
+ * quarantined again within the length of its last quarantine after it ended
+ * is quarantined twice as long
+ */
+local void countBadByte(device_t *device, uint64_t time)
+{
+   // If not quarantining...
+   if(!appConfig.quarantineBytes)
+      return;
+
+   // If a new one second window...
+   if(time - device->windowStart >= NS_PER_SEC)
+   {
+      device->windowStart = time;
+      device->windowBad = 0;
+   }
+   if(++device->windowBad <= appConfig.quarantineBytes)
+      return;
+
+   // If quarantined again soon after the last quarantine ended...
+   if(device->backoffNs && time - device->quarantineEnd < device->backoffNs)
+      device->backoffNs = (device->backoffNs * 2 > QUARANTINE_MAX_MS * 1000000ULL)?QUARANTINE_MAX_MS * 1000000ULL:device->backoffNs * 2;
+   else
+      device->backoffNs = QUARANTINE_MIN_MS * 1000000ULL;
+   device->quarantineEnd = time + device->backoffNs;
+   device->windowBad = 0;
+   ++device->quarantines;
+   LOG("Keypad %d quarantined for %llu ms\n\r", device->address, (unsigned long long)(device->backoffNs / 1000000));
+}
+
+/*
+ * Decode the multi-drop bus framing. Returns the keypad that sent the byte
+ * if it's a key, or NULL if it's part of the framing or from an unknown
+ * address
+ */
+local device_t *deframeSerial(unsigned char key)
+{
+   switch(frameState)
+   {
+      case FRAME_IDLE:
+         // If the start of DLE STX...
+         if(key == FRAME_DLE)
+            frameState = FRAME_IDLE_DLE;
+         else
+            ++stats.frameErrors;
+         return(NULL);
+      case FRAME_IDLE_DLE:
+         if(key == FRAME_STX)
+            frameState = FRAME_ADDRESS;
+         else
+         {
+            ++stats.frameErrors;
+            frameState = FRAME_IDLE;
+         }
+         return(NULL);
+      case FRAME_ADDRESS_DLE:
+         // If not an escaped DLE address, resynchronize
+         if(key != FRAME_DLE)
+         {
+            ++stats.frameErrors;
+            frameState = (key == FRAME_STX)?FRAME_ADDRESS:FRAME_IDLE;
+            return(NULL);
+         }
+         // Fall through
+      case FRAME_ADDRESS:
+         if(key == FRAME_DLE && frameState == FRAME_ADDRESS)
+         {
+            frameState = FRAME_ADDRESS_DLE;
+            return(NULL);
+         }
+         // Look up the keypad by address
+         frameDevice = deviceOf[key]?&devices[deviceOf[key]]:NULL;
+         if(frameDevice == NULL)
+            ++stats.unknownAddress;
+         frameState = FRAME_KEYS;
+         return(NULL);
+      case FRAME_KEYS:
+         if(key == FRAME_DLE)
+         {
+            frameState = FRAME_KEYS_DLE;
+            return(NULL);
+         }
+         return(frameDevice);
+      case FRAME_KEYS_DLE:
+         // If an escaped DLE key...
+         if(key == FRAME_DLE)
+         {
+            frameState = FRAME_KEYS;
+            return(frameDevice);
+         }
+         // Else if the end of the frame...
+         if(key == FRAME_ETX)
+            ++stats.frames;
+         // Else if a new frame started before this one ended...
+         else
+            ++stats.frameErrors;
+         frameState = (key == FRAME_STX)?FRAME_ADDRESS:FRAME_IDLE;
+         return(NULL);
+   }
+   return(NULL);
+}
+
+/*
+ * Return the CLOCK_MONOTONIC time in nanoseconds
+ */
+local uint64_t monotonicTime(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+/*
+ * Decode the PARMRK marks in the received byte stream. Returns true if the
+ * byte should be mapped, false if it is part of a mark or dropped
+ */
+local bool unmarkSerial(unsigned char *key)
+{
+   switch(markState)
+   {
+      case MARK_IDLE:
+         // If start of a mark or escaped \377...
+         if(*key == 0xff)
+         {
+            markState = MARK_FF;
+            return(false);
+         }
+         return(true);
+      case MARK_FF:
+         // If escaped \377, map it...
+         if(*key == 0xff)
+         {
+            markState = MARK_IDLE;
+            return(true);
+         }
+         // If error mark, the errored byte follows...
+         if(*key == 0)
+         {
+            markState = MARK_FF00;
+            return(false);
+         }
+         // Else not a valid mark, map the byte
+         markState = MARK_IDLE;
+         return(true);
+      case MARK_FF00:
+      default:
+         markState = MARK_IDLE;
+         // If break condition...
+         if(*key == 0)
+         {
+            ++stats.breaks;
+            LOG(" In - Break received\n\r");
+            return(false);
+         }
+         ++stats.marked;
+         LOG(" In - Parity/framing error code: %03d\n\r", *key);
+         // If dropping errored bytes...
+         if(appConfig.errors == ERRORS_DROP)
+         {
+            ++stats.dropped;
+            return(false);
+         }
+         return(true);
+   }
+}
+
+/*
+ * Read the driver's serial error counters. Logs any new overrun, parity,
+ * framing, and break errors since the last poll
+ */
+local void pollSerialErrors(int fd)
+{
+   persistent bool               supported = true;
+   struct serial_icounter_struct icount;
+
+   // If the driver doesn't support the counters, don't ask again
+   if(!supported)
+      return;
+
+   if(ioctl(fd, TIOCGICOUNT, &icount))
+   {
+      supported = false;
+      LOG("Serial driver does not support TIOCGICOUNT\n\r");
+      return;
+   }
+
+   // If any of the error counters changed...
+   if(stats.icountValid && (icount.overrun != stats.icount.overrun ||
+                            icount.buf_overrun != stats.icount.buf_overrun ||
+                            icount.parity != stats.icount.parity ||
+                            icount.frame != stats.icount.frame ||
+                            icount.brk != stats.icount.brk))
+      LOG(" Serial errors - overrun: %d buf_overrun: %d parity: %d frame: %d break: %d\n\r",
+          icount.overrun, icount.buf_overrun, icount.parity, icount.frame, icount.brk);
+
+   stats.icount = icount;
+   stats.icountValid = true;
+}
+
+/*
+ * Queue a byte to send to the keyboard. The byte is written immediately if
+ * the port is idle, otherwise when the event loop reports it is writable
+ */
+local void queueSerial(int fd, unsigned char data)
+{
+   bool idle = (txQueue.head == txQueue.tail);
+
+   // If the queue is full, drop the byte...
+   if((txQueue.head + 1) % SERIAL_TX_QUEUE == txQueue.tail)
+   {
+      ++txQueue.dropped;
+      LOG(" Feedback - queue full, dropped: %lu\n\r", txQueue.dropped);
+      return;
+   }
+
+   txQueue.data[txQueue.head] = data;
+   txQueue.head = (txQueue.head + 1) % SERIAL_TX_QUEUE;
+
+   // If the queue was empty, try to write it now
+   if(idle)
+      flushSerial(fd);
+}
+
+/*
+ * Write as much of the queue as the serial port will accept without blocking
+ */
+local void flushSerial(int fd)
+{
+   // While bytes are queued...
+   while(txQueue.head != txQueue.tail)
+   {
+      // Write the contiguous run of bytes up to the end of the queue
+      unsigned int   end = (txQueue.head > txQueue.tail)?txQueue.head:SERIAL_TX_QUEUE;
+      ssize_t        count = write(fd, &txQueue.data[txQueue.tail], end - txQueue.tail);
+
+      // If the port is busy, wait for it to become writable...
+      if(count<0)
+      {
+         if(errno==EINTR)
+            continue;
+         if(errno!=EAGAIN)
+            exitApp("Unable to write to the serial device", false, -20);
+         if(!txQueue.blocked)
+            watchEvents(fd, serialEvents | EPOLLOUT, EPOLL_CTL_MOD);
+         txQueue.blocked = true;
+         return;
+      }
+
+      txQueue.tail = (txQueue.tail + (unsigned int)count) % SERIAL_TX_QUEUE;
+   }
+
+   // Queue is empty, stop watching for writable
+   if(txQueue.blocked)
+      watchEvents(fd, serialEvents, EPOLL_CTL_MOD);
+   txQueue.blocked = false;
+}
+
+// Reader Thread Functions ****************************************************
+/*
+ * Create the queue and start the thread that reads the serial port. The
+ * event loop writes the queued keys to the output
+ */
+local void startReader(int fd)
+{
+   persistent int reader_fd;
+   struct pollfd  started;
+
+   if((keyQueue.dataFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1 ||
+      (keyQueue.spaceFd = eventfd(0, EFD_CLOEXEC)) == -1 ||
+      (keyQueue.stopFd = eventfd(0, EFD_CLOEXEC)) == -1)
+      exitApp("Unable to create the reader thread events", false, -33);
+   watchEvents(keyQueue.dataFd, EPOLLIN, EPOLL_CTL_ADD);
+
+   reader_fd = fd;
+   if(pthread_create(&readerThread, NULL, runReader, &reader_fd))
+      exitApp("Unable to start the reader thread", false, -33);
+
+   // Wait for the thread to run, so glibc has set it up before the seccomp
+   // filter is installed. The wake is left for the event loop, which finds
+   // the queue empty
+   started = (struct pollfd){.fd = keyQueue.dataFd, .events = POLLIN};
+   while(poll(&started, 1, -1) < 0)
+      if(errno != EINTR)
+         exitApp("Unable to wait for the reader thread", false, -33);
+   LOG("Started the reader thread\n\r");
+}
+
+/*
+ * Reader thread. Drains the serial port into the queue, timestamping each
+ * byte as it's read. If the queue is full, waits for the event loop to
+ * free space so no bytes are lost
+ */
+local void *runReader(void *arg)
+{
+   int            fd = *(int *)arg;
+   struct pollfd  ready[2] = {{.fd = fd, .events = POLLIN}, {.fd = keyQueue.stopFd, .events = POLLIN}};
+   unsigned char  keys[SERIAL_READ_SIZE];
+   uint64_t       signal = 1;
+   unsigned       head = 0;
+   int            ret;
+
+   // Tell startReader() the thread is running
+   if(write(keyQueue.dataFd, &signal, sizeof(signal)) < 0)
+      return(NULL);
+
+   do
+   {
+      uint64_t          time;
+      ssize_t           count;
+
+      // Wait for the serial port and read the available keys
+      ret = poll(ready, 2, -1);
+      // If stopping for a handoff, leave the unread bytes in the driver
+      if(ret > 0 && ready[1].revents)
+         break;
+      if(ret < 0 && errno != EINTR)
+         count = -1;
+      else if((count = read(fd, keys, sizeof(keys))) < 0 && (errno == EAGAIN || errno == EINTR))
+         continue;
+
+      // If the read failed or the port closed, stop and let the event loop exit
+      if(count <= 0)
+         return(stopReading(head, (count < 0)?errno:0));
+
+      time = monotonicTime();
+
+      // For each key read...
+      for(ssize_t i=0;i<count;++i)
+      {
+         unsigned tail, depth;
+
+         // While the queue is full, wait for the event loop to free space
+         while((depth = head - (tail = __atomic_load_n(&keyQueue.tail, __ATOMIC_ACQUIRE))) == KEY_QUEUE_SIZE)
+         {
+            uint64_t freed;
+
+            __atomic_store_n(&keyQueue.readerWaiting, true, __ATOMIC_SEQ_CST);
+            // If space was freed before the flag was seen, don't wait
+            if(head - __atomic_load_n(&keyQueue.tail, __ATOMIC_SEQ_CST) == KEY_QUEUE_SIZE)
+               if(read(keyQueue.spaceFd, &freed, sizeof(freed)) < 0 && errno != EINTR)
+               {
+                  // The queue is still full, stop with the keys queued
+                  __atomic_store_n(&keyQueue.readerWaiting, false, __ATOMIC_RELAXED);
+                  return(stopReading(head, errno));
+               }
+            __atomic_store_n(&keyQueue.readerWaiting, false, __ATOMIC_RELAXED);
+         }
+
+         keyQueue.records[head % KEY_QUEUE_SIZE].time = time;
+         keyQueue.records[head % KEY_QUEUE_SIZE].key = keys[i];
+         ++head;
+
+         // Track the deepest the queue has been
+         if(depth + 1 > keyQueue.highWater)
+            __atomic_store_n(&keyQueue.highWater, depth + 1, __ATOMIC_RELAXED);
+      }
+
+      // Publish the keys and wake the event loop
+      __atomic_store_n(&keyQueue.head, head, __ATOMIC_RELEASE);
+      if(write(keyQueue.dataFd, &signal, sizeof(signal)) < 0)
+         break;
+   } while(true);
+
+   return(NULL);
+}
+
+/*
+ * Publish the keys queued, mark the reader stopped, and wake the event loop,
+ * which exits once it has mapped them. Returns the thread's result
+ */
+local void *stopReading(unsigned head, int error)
+{
+   uint64_t signal = 1;
+
+   keyQueue.readerErrno = error;
+   __atomic_store_n(&keyQueue.head, head, __ATOMIC_RELEASE);
+   __atomic_store_n(&keyQueue.readerStopped, true, __ATOMIC_RELEASE);
+   if(write(keyQueue.dataFd, &signal, sizeof(signal)) < 0)
+      return(NULL);
+   return(NULL);
+}
+
+/*
+ * Map the keys queued by the reader thread and write them to the output
+ */
+local void readQueue(int uinputFd)
+{
+   uint64_t          signals, time;
+   unsigned          head, tail = keyQueue.tail;
+   unsigned long     keys = stats.keys, accepted = keys;
+
+   // Acknowledge the reader
+   if(read(keyQueue.dataFd, &signals, sizeof(signals)) < 0 && errno != EAGAIN)
+      exitApp("Unable to read the reader thread event", false, -33);
+
+   head = __atomic_load_n(&keyQueue.head, __ATOMIC_ACQUIRE);
+   time = monotonicTime();
+
+   // If profiling, count from decoding the keys to writing their events
+   if(profile.fd != -1)
+      readCounters(profile.start);
+
+   // For each queued key...
+   for(;tail != head;++tail)
+   {
+      keyrecord_t *record = &keyQueue.records[tail % KEY_QUEUE_SIZE];
+
+      // Track the longest a key waited in the queue
+      if(time - record->time > stats.queueDelayMax)
+         stats.queueDelayMax = time - record->time;
+
+      processKey(record->key, record->time, uinputFd);
+
+      // If measuring latency, mark the records that weren't keys, such as
+      // bus framing, so only keys are counted
+      if(measureLatency && stats.keys == accepted)
+         record->time = 0;
+      accepted = stats.keys;
+   }
+
+   // Write the events batched for the keys
+   flushFrame(uinputFd);
+   if(profile.fd != -1)
+      endProfile(stats.keys - keys);
+
+   // If a key was made to autorepeat, schedule its first repeat
+   if(repeat.key != KEY_RESERVED && repeat.next == 0)
+      startRepeat(time);
+
+   // If publishing stats or metrics, count each key's latency before its
+   // record is freed, and update the stats page
+   if(measureLatency)
+   {
+      uint64_t now = monotonicTime();
+
+      for(unsigned i=keyQueue.tail;i != tail;++i)
+         if(keyQueue.records[i % KEY_QUEUE_SIZE].time)
+            recordLatency(now, keyQueue.records[i % KEY_QUEUE_SIZE].time, 1);
+      if(statsPage)
+         publishStats(now);
+   }
+
+   // Free the space and wake the reader if it's waiting for it
+   __atomic_store_n(&keyQueue.tail, tail, __ATOMIC_SEQ_CST);
+   if(__atomic_load_n(&keyQueue.readerWaiting, __ATOMIC_SEQ_CST))
+      if(write(keyQueue.spaceFd, &signals, sizeof(signals)) < 0)
+         exitApp("Unable to wake the reader thread", false, -33);
+
+   // If the reader stopped, exit as the single threaded loop does
+   if(__atomic_load_n(&keyQueue.readerStopped, __ATOMIC_ACQUIRE) && tail == __atomic_load_n(&keyQueue.head, __ATOMIC_ACQUIRE))
+   {
+      errno = keyQueue.readerErrno;
+      processKeys(NULL, errno?-1:0, 0, uinputFd);
+   }
+}
+
+// io_uring Event Loop Functions **********************************************
+/*
+ * Create the io_uring and map its rings. Returns false if the kernel doesn't
+ * support io_uring or the features the loop needs, so epoll is used instead
+ */
+local bool setupUring(void)
+{
+   struct io_uring_params  params;
+   struct iovec            buffer = {.iov_base = uringBuffer, .iov_len = sizeof(uringBuffer)};
+   size_t                  sqSize, cqSize;
+   unsigned char           *sq, *cq;
+   int                     fd;
+
+   memset(&params, 0, sizeof(params));
+   if((fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params)) < 0)
+      return(false);
+
+   // Multishot poll is available from the same kernel as CQE_SKIP
+   if(!(params.features & IORING_FEAT_CQE_SKIP) || !(params.features & IORING_FEAT_NODROP))
+   {
+      close(fd);
+      return(false);
+   }
+
+   // Map the submission and completion rings, a single mapping if supported
+   sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+   cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+   if(params.features & IORING_FEAT_SINGLE_MMAP)
+      sqSize = cqSize = (sqSize > cqSize)?sqSize:cqSize;
+
+   sq = mmap(NULL, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+   if(sq == MAP_FAILED)
+      exitApp("Unable to map the io_uring submission ring", false, -32);
+   cq = sq;
+   if(!(params.features & IORING_FEAT_SINGLE_MMAP))
+   {
+      cq = mmap(NULL, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if(cq == MAP_FAILED)
+         exitApp("Unable to map the io_uring completion ring", false, -32);
+   }
+   uring.sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+   if(uring.sqes == MAP_FAILED)
+      exitApp("Unable to map the io_uring submission entries", false, -32);
+
+   uring.sqHead = (unsigned *)(sq + params.sq_off.head);
+   uring.sqTail = (unsigned *)(sq + params.sq_off.tail);
+   uring.sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+   uring.sqArray = (unsigned *)(sq + params.sq_off.array);
+   uring.sqEntries = params.sq_entries;
+   uring.cqHead = (unsigned *)(cq + params.cq_off.head);
+   uring.cqTail = (unsigned *)(cq + params.cq_off.tail);
+   uring.cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+   uring.cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+   // Register the serial read buffer so reads don't map it each time
+   if(syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, &buffer, 1))
+      exitApp("Unable to register the io_uring read buffer", false, -32);
+
+   // Output writes are batched into io_uring submissions
+   uring.fd = fd;
+   uring.writeOp = (appConfig.output == OUTPUT_SOCKET)?IORING_OP_SEND:IORING_OP_WRITE;
+   writeEvents = writeUring;
+   appConfig.batch = true;
+
+   LOG("Created io_uring with %u entries\n\r", params.sq_entries);
+   return(true);
+}
+
+/*
+ * Get the next submission entry, submitting the queue if it is full
+ */
+local struct io_uring_sqe *getSqe(int fd, uringop_t op)
+{
+   struct io_uring_sqe  *sqe;
+   unsigned             tail = *uring.sqTail;
+   uringcqe_t           cqe;
+   int                  retries = 0;
+
+   // While the submission queue is full, submit it. The kernel refuses
+   // (EBUSY) while the completion queue is full, so defer the completions
+   // to make room, and wait for one if nothing is ready
+   while(tail - __atomic_load_n(uring.sqHead, __ATOMIC_ACQUIRE) == uring.sqEntries)
+   {
+      if(++retries > URING_ENTRIES)
+         exitApp("Unable to submit the io_uring submission queue", false, -32);
+      submitUring(retries > 1);
+      while(popCqe(&cqe))
+         stashCqe(&cqe);
+   }
+
+   sqe = &uring.sqes[tail & *uring.sqMask];
+   memset(sqe, 0, sizeof(*sqe));
+   sqe->fd = fd;
+   sqe->user_data = ((uint64_t)op << 32) | (uint32_t)fd;
+   sqe->opcode = IORING_OP_POLL_ADD;
+
+   uring.sqArray[tail & *uring.sqMask] = tail & *uring.sqMask;
+   __atomic_store_n(uring.sqTail, tail + 1, __ATOMIC_RELEASE);
+   ++uring.queued;
+
+   return(sqe);
+}
+
+/*
+ * Submit the queued entries with a single io_uring_enter, optionally waiting
+ * for a completion
+ */
+local void submitUring(bool wait)
+{
+   int ret;
+
+   ret = (int)syscall(__NR_io_uring_enter, uring.fd, uring.queued, wait?1:0, wait?IORING_ENTER_GETEVENTS:0, NULL, 0);
+   ++stats.waits;
+   if(ret < 0)
+   {
+      if(errno == EINTR || errno == EAGAIN || errno == EBUSY)
+         return;
+      exitApp("io_uring_enter returned an error", false, -32);
+   }
+   uring.queued -= (unsigned)ret;
+}
+
+/*
+ * Pop the next completion from the completion ring
+ */
+local bool popCqe(uringcqe_t *cqe)
+{
+   struct io_uring_cqe  *entry;
+   unsigned             head = *uring.cqHead;
+
+   // If the completion ring is empty...
+   if(head == __atomic_load_n(uring.cqTail, __ATOMIC_ACQUIRE))
+      return(false);
+
+   entry = &uring.cqes[head & *uring.cqMask];
+   cqe->user_data = entry->user_data;
+   cqe->res = entry->res;
+   cqe->flags = entry->flags;
+   __atomic_store_n(uring.cqHead, head + 1, __ATOMIC_RELEASE);
+   return(true);
+}
+
+/*
+ * Pop the next completion, deferred completions first
+ */
+local bool nextCqe(uringcqe_t *cqe)
+{
+   // If completions were deferred while waiting for a write...
+   if(uring.stashHead != uring.stashTail)
+   {
+      *cqe = uring.stash[uring.stashHead++ % URING_STASH];
+      return(true);
+   }
+
+   return(popCqe(cqe));
+}
+
+/*
+ * Defer a completion until the event loop pops it
+ */
+local void stashCqe(const uringcqe_t *cqe)
+{
+   if(uring.stashTail - uring.stashHead == URING_STASH)
+      exitApp("Too many io_uring completions deferred", false, -32);
+   uring.stash[uring.stashTail++ % URING_STASH] = *cqe;
+}
+
+/*
+ * Read the serial port once it's readable. The poll and read are linked so
+ * the read runs in the kernel as soon as bytes arrive
+ */
+local void armSerialRead(int fd)
+{
+   struct io_uring_sqe *sqe;
+
+   sqe = getSqe(fd, URING_POLL);
+   sqe->poll32_events = POLLIN;
+   sqe->flags = IOSQE_IO_LINK;
+
+   sqe = getSqe(fd, URING_READ);
+   sqe->opcode = IORING_OP_READ_FIXED;
+   sqe->addr = (uint64_t)(uintptr_t)uringBuffer;
+   sqe->len = sizeof(uringBuffer);
+   sqe->off = (uint64_t)-1;
+   sqe->buf_index = 0;
+}
+
+/*
+ * Poll a file descriptor until it is removed, one completion per event
+ */
+local void armWatch(int fd, unsigned int events)
+{
+   struct io_uring_sqe *sqe = getSqe(fd, URING_WATCH);
+
+   sqe->poll32_events = events;
+   sqe->len = IORING_POLL_ADD_MULTI;
+}
+
+/*
+ * Run the io_uring event loop. Each io_uring_enter submits the re-armed
+ * serial reads and the batched output writes, and waits for completions
+ */
+local void runUring(void)
+{
+   uringcqe_t cqe;
+
+   do
+   {
+      submitUring(true);
+
+      // For each completion...
+      while(nextCqe(&cqe))
+         onUringCompletion(&cqe);
+   } while(true);
+}
+
+/*
+ * Handle an io_uring completion
+ */
+local void onUringCompletion(uringcqe_t *cqe)
+{
+   int fd = (int)(uint32_t)cqe->user_data;
+
+   switch((uringop_t)(cqe->user_data >> 32))
+   {
+      case URING_POLL:
+         // The linked read reports the result
+         break;
+      case URING_READ:
+         // If the poll woke without data, or the link was cut...
+         if(cqe->res == -EAGAIN || cqe->res == -ECANCELED || cqe->res == -EINTR)
+         {
+            armSerialRead(fd);
+            break;
+         }
+         // Map the keys, queueing the events for one write, then read again
+         if(cqe->res < 0)
+            errno = -cqe->res;
+         processKeys(uringBuffer, cqe->res < 0?-1:cqe->res, monotonicTime(), outputFd);
+         armSerialRead(fd);
+         break;
+      case URING_WRITE:
+         uring.writing = false;
+         // If the output wasn't ready or took part of the events, write
+         // the rest of the same events once it's writable
+         if(cqe->res == -EAGAIN || (cqe->res > 0 &&
+            uring.writeOffset + (size_t)cqe->res < uring.writeCount[!uring.writeNext] * sizeof(struct input_event)))
+         {
+            if(cqe->res > 0)
+               uring.writeOffset += (size_t)cqe->res;
+            if(pending.stallStart == 0)
+            {
+               pending.stallStart = monotonicTime();
+               ++pending.stalls;
+               throttleSerial(true);
+            }
+            uring.writeNext = !uring.writeNext;
+            submitWrite(fd);
+            break;
+         }
+         // If the output failed...
+         if(cqe->res <= 0)
+         {
+            errno = (cqe->res < 0)?-cqe->res:EIO;
+            exitApp("Failed to write to output\n\r", false, -12);
+         }
+         uring.writeCount[!uring.writeNext] = 0;
+         uring.writeOffset = 0;
+         // Write the events queued while writing, then move the events that
+         // overflowed into the pending queue to the free write
+         submitWrite(fd);
+         flushPending(fd);
+         // If the output had stalled, it's caught up
+         if(pending.stallStart && pending.end == pending.start)
+         {
+            uint64_t stall = monotonicTime() - pending.stallStart;
+
+            pending.stallTotal += stall;
+            if(stall > pending.stallMax)
+               pending.stallMax = stall;
+            pending.stallStart = 0;
+            throttleSerial(false);
+         }
+         break;
+      case URING_WATCH:
+         // If the multishot poll ended, poll again unless it was removed
+         if(!(cqe->flags & IORING_CQE_F_MORE) && cqe->res != -ECANCELED)
+            armWatch(fd, POLLIN);
+         if(cqe->res > 0)
+            dispatchEvent(fd, (unsigned int)cqe->res);
+         break;
+      case URING_POLLOUT:
+         if(cqe->res > 0)
+            flushSerial(fd);
+         break;
+      case URING_CANCEL:
+         break;
+   }
+}
+
+/*
+ * Queue events to write to the output. Only one write is in flight at a
+ * time so the events stay in order. Events batched while it's in flight are
+ * written when it completes
+ */
+local ssize_t writeUring(int fd, const void *data, size_t size)
+{
+   size_t count = size / sizeof(struct input_event);
+
+   // If the next write is full, the output is behind. Take the events that
+   // fit and leave the rest to writeOutput()'s pending queue rather than
+   // waiting here with the serial port and timers unserviced
+   if(uring.writeCount[uring.writeNext] + count > URING_WRITE_EVENTS)
+   {
+      count = URING_WRITE_EVENTS - uring.writeCount[uring.writeNext];
+      if(count == 0)
+      {
+         errno = EAGAIN;
+         return(-1);
+      }
+   }
+
+   memcpy(&uring.writes[uring.writeNext][uring.writeCount[uring.writeNext]], data, count * sizeof(struct input_event));
+   uring.writeCount[uring.writeNext] += count;
+
+   // If no write is in flight, write now
+   submitWrite(fd);
+
+   return((ssize_t)(count * sizeof(struct input_event)));
+}
+
+/*
+ * If no write is in flight and events are queued, queue the write. It's
+ * submitted with the next io_uring_enter
+ */
+local void submitWrite(int fd)
+{
+   struct io_uring_sqe  *sqe;
+   int                  next = uring.writeNext;
+
+   if(uring.writing || uring.writeCount[next] == 0)
+      return;
+
+   // If resuming a write the output stalled on, wait until it's writable
+   if(uring.writeOffset || pending.stallStart)
+   {
+      sqe = getSqe(fd, URING_POLL);
+      sqe->poll32_events = POLLOUT;
+      sqe->flags = IOSQE_IO_LINK;
+   }
+
+   sqe = getSqe(fd, URING_WRITE);
+   sqe->opcode = uring.writeOp;
+   sqe->addr = (uint64_t)(uintptr_t)((unsigned char *)uring.writes[next] + uring.writeOffset);
+   sqe->len = (unsigned)(uring.writeCount[next] * sizeof(struct input_event) - uring.writeOffset);
+   if(uring.writeOp == IORING_OP_SEND)
+      sqe->msg_flags = MSG_NOSIGNAL;
+   else
+      sqe->off = (uint64_t)-1;
+
+   uring.writing = true;
+   uring.writeNext = !next;
+}
+
+/*
+ * Wait for the write in flight, then switch the output back to direct
+ * writes so the exit path can write synchronously
+ */
+local void stopUring(void)
+{
+   uringcqe_t cqe;
+
+   // If io_uring isn't running...
+   if(uring.fd == -1 || outputFd == -1)
+      return;
+
+   // Wait for the write in flight
+   while(uring.writing)
+   {
+      submitUring(true);
+      while(uring.writing && nextCqe(&cqe))
+         if((uringop_t)(cqe.user_data >> 32) == URING_WRITE)
+            onUringCompletion(&cqe);
+   }
+
+   // Write the events queued behind it directly. If events overflowed into
+   // the pending queue, these go first, so wait for the output like
+   // drainPending() does
+   writeEvents = outputs[appConfig.output].write;
+   if(uring.writeCount[uring.writeNext] && pending.end == pending.start)
+      writeOutput(outputFd, uring.writes[uring.writeNext], uring.writeCount[uring.writeNext] * sizeof(struct input_event));
+   else if(uring.writeCount[uring.writeNext])
+   {
+      const unsigned char  *data = (const unsigned char *)uring.writes[uring.writeNext];
+      size_t               size = uring.writeCount[uring.writeNext] * sizeof(struct input_event);
+      struct pollfd        ready = {.fd = outputFd, .events = POLLOUT};
+      ssize_t              ret;
+
+      while(size && (ret = writeEvents(outputFd, data, size)) != (ssize_t)size)
+      {
+         if(ret < 0 && errno != EAGAIN)
+            exitApp("Failed to write to output\n\r", false, -12);
+         if(ret > 0)
+         {
+            data += ret;
+            size -= (size_t)ret;
+         }
+         if(poll(&ready, 1, OUTPUT_DRAIN_MS) <= 0)
+            break;
+      }
+   }
+   uring.writeCount[uring.writeNext] = 0;
+
+   close(uring.fd);
+   uring.fd = -1;
+}
+
+// Privilege Separation Functions *********************************************
+/*
+ * Drop from root to the user and group once the devices are open. Removes
+ * all capabilities so they can't be regained
+ */
+local void dropPrivileges(char *user)
+{
+   struct passwd  *pw;
+   struct group   *gr;
+   char           *group;
+   gid_t          gid;
+
+   // Split the user and optional group
+   if((group = strchr(user, ':')) != NULL)
+      *group++ = '\0';
+
+   // Look up the user and group
+   if((pw = getpwnam(user)) == NULL)
+      exitApp("Unknown user", false, -26);
+   gid = pw->pw_gid;
+   if(group)
+   {
+      if((gr = getgrnam(group)) == NULL)
+         exitApp("Unknown group", false, -26);
+      gid = gr->gr_gid;
+   }
+
+   // If writing the metrics file, give it to the user while root still can
+   if(metricsDirFd != -1)
+      chownMetricsFile(pw->pw_uid, gid);
+
+   // Remove every capability from the bounding set so exec can't regain them
+   for(int cap=0;prctl(PR_CAPBSET_READ, cap, 0, 0, 0) >= 0;++cap)
+      if(prctl(PR_CAPBSET_DROP, cap, 0, 0, 0) && errno != EINVAL)
+         exitApp("Unable to drop the capability bounding set", false, -26);
+
+   // Switch the group and then the user
+   if(setgroups(0, NULL) || setgid(gid) || setuid(pw->pw_uid))
+      exitApp("Unable to drop privileges", false, -26);
+
+   // If root could be regained, the drop failed...
+   if(pw->pw_uid != 0 && (setuid(0) == 0 || seteuid(0) == 0))
+      exitApp("Privileges were not dropped", false, -26);
+
+   // Clear the permitted, effective, and inheritable capabilities
+   struct __user_cap_header_struct  header = {.version = _LINUX_CAPABILITY_VERSION_3, .pid = 0};
+   struct __user_cap_data_struct    data[_LINUX_CAPABILITY_U32S_3];
+
+   memset(data, 0, sizeof(data));
+   if(syscall(SYS_capset, &header, data))
+      exitApp("Unable to clear capabilities", false, -26);
+
+   LOG("Dropped privileges to uid: %d gid: %d\n\r", (int)pw->pw_uid, (int)gid);
+}
+
+/*
+ * Install a seccomp filter allowing only the system calls used by the event
+ * loop. The filter is built once here and adds no work to the key path
+ */
+local void installSeccomp(void)
+{
+#ifdef SECCOMP_ARCH
+   const size_t         syscalls = sizeof(allowedSyscalls)/sizeof(allowedSyscalls[0]);
+   const size_t         metrics = (appConfig.metrics == METRICS_FILE)?sizeof(metricsSyscalls)/sizeof(metricsSyscalls[0]):0;
+   struct sock_filter   filter[4 + 2 * (sizeof(allowedSyscalls) + sizeof(metricsSyscalls))/sizeof(int) + 1];
+   struct sock_fprog    program;
+   size_t               length = 0;
+
+   // Kill the process if the system call is from another architecture
+   filter[length++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, arch));
+   filter[length++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, SECCOMP_ARCH, 1, 0);
+   filter[length++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL_PROCESS);
+
+   // Allow each of the system calls the event loop needs
+   filter[length++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr));
+   for(size_t i=0;i<syscalls;++i)
+   {
+      filter[length++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (unsigned int)allowedSyscalls[i], 0, 1);
+      filter[length++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+   }
+   // If writing the metrics file, allow creating and renaming it
+   for(size_t i=0;i<metrics;++i)
+   {
+      filter[length++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (unsigned int)metricsSyscalls[i], 0, 1);
+      filter[length++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+   }
+
+   // Kill the process for any other system call
+   filter[length++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL_PROCESS);
+
+   program.len = (unsigned short)length;
+   program.filter = filter;
+
+   // Required to install a filter without CAP_SYS_ADMIN
+   if(prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0))
+      exitApp("Unable to set no new privileges", false, -27);
+   // Synchronize the filter to the reader thread
+   if(syscall(__NR_seccomp, SECCOMP_SET_MODE_FILTER, SECCOMP_FILTER_FLAG_TSYNC, &program))
+      exitApp("Unable to install the seccomp filter", false, -27);
+
+   LOG("Installed seccomp filter allowing %zu system calls\n\r", syscalls + metrics);
+#else
+   exitApp("seccomp is not supported on this architecture", false, -27);
+#endif
+}
+
+// Upgrade Functions **********************************************************
+/*
+ * Connect to the upgrade socket of a running serkey and take over its serial
+ * port and output. Returns false if no serkey is listening
+ */
+local bool takeOver(char *path)
+{
+   struct sockaddr_un   addr;
+   handoff_t            state = {.magic = HANDOFF_MAGIC, .output = appConfig.output, .pid = getpid()};
+   int                  fd, fds[3];
+   union {
+      char              buffer[CMSG_SPACE(sizeof(fds))];
+      struct cmsghdr    align;
+   }                    control;
+   struct iovec         iov = {.iov_base = &state, .iov_len = sizeof(state)};
+   struct msghdr        msg = {.msg_iov = &iov, .msg_iovlen = 1, .msg_control = control.buffer, .msg_controllen = sizeof(control.buffer)};
+   struct pollfd        ready;
+   struct cmsghdr       *cmsg;
+   ssize_t              received = -1;
+
+   if(strlen(path) >= sizeof(addr.sun_path))
+      exitApp("Upgrade socket path is too long", false, -42);
+
+   if((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1)
+      exitApp("Unable to create the upgrade socket", false, -42);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+
+   // If no serkey is running...
+   if(connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+   {
+      close(fd);
+      return(false);
+   }
+
+   // Request the devices and wait while the running serkey finishes the
+   // keys it has read
+   ready.fd = fd;
+   ready.events = POLLIN;
+   if(send(fd, &state, sizeof(state), MSG_NOSIGNAL) != sizeof(state) ||
+      poll(&ready, 1, HANDOFF_TIMEOUT_MS) != 1 ||
+      (received = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC)) != sizeof(state))
+   {
+      // The running serkey closes the connection if it refuses
+      if(received == 0)
+         errno = ECONNREFUSED;
+      exitApp("The running serkey refused the handoff", false, -42);
+   }
+   close(fd);
+
+   // The systemd notify socket follows the devices if the running serkey
+   // was started by systemd
+   cmsg = CMSG_FIRSTHDR(&msg);
+   if(state.magic != HANDOFF_MAGIC || cmsg == NULL || cmsg->cmsg_type != SCM_RIGHTS ||
+      (cmsg->cmsg_len != CMSG_LEN(2 * sizeof(int)) && cmsg->cmsg_len != CMSG_LEN(3 * sizeof(int))))
+      exitApp("Invalid handoff from the running serkey", false, -42);
+   memcpy(fds, CMSG_DATA(cmsg), cmsg->cmsg_len - CMSG_LEN(0));
+   if(cmsg->cmsg_len == CMSG_LEN(3 * sizeof(int)))
+   {
+      notifyFd = fds[2];
+      watchdogMs = state.watchdogMs;
+   }
+
+   // Restore the configuration the first serkey found at exit, and release
+   // the keys still held
+   ttyFd = fds[0];
+   ttyConfig = state.ttyConfig;
+   outputFd = fds[1];
+   writeEvents = outputs[appConfig.output].write;
+   memcpy(heldKeys, state.heldKeys, sizeof(heldKeys));
+   frameState = state.frameState;
+   frameDevice = (state.frameAddress >= 0 && deviceOf[state.frameAddress])?&devices[deviceOf[state.frameAddress]]:NULL;
+
+   // Apply this serkey's settings. The bytes the driver has buffered are kept
+   if(configSerial(ttyFd, appConfig.speed, appConfig.parity, appConfig.databits, appConfig.stopbits, appConfig.errors, appConfig.flowControl))
+      exitApp("Unable to set the serial device configuration",false,-1);
+
+   return(true);
+}
+
+/*
+ * Listen on the upgrade socket for the next serkey, replacing the socket of
+ * the serkey that handed off
+ */
+local int listenUpgrade(char *path)
+{
+   struct sockaddr_un   addr;
+   mode_t               mask;
+   int                  fd;
+
+   if(strlen(path) >= sizeof(addr.sun_path))
+      exitApp("Upgrade socket path is too long", false, -42);
+
+   if((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1)
+      exitApp("Unable to create the upgrade socket", false, -42);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+
+   // Only the user serkey started as may take over the devices
+   unlink(path);
+   mask = umask(0077);
+   if(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) || listen(fd, 1))
+      exitApp("Unable to listen on the upgrade socket", false, -42);
+   umask(mask);
+
+   return(fd);
+}
+
+/*
+ * Accept a new serkey on the upgrade socket. Its request is read by
+ * handOff() once it arrives, so a client that connects and sends nothing
+ * doesn't stall the event loop
+ */
+local void acceptUpgrade(void)
+{
+   int fd;
+
+   if((fd = accept(upgradeFd, NULL, NULL)) == -1)
+      return;
+
+   // One handoff at a time, the newest connection replaces one that hasn't
+   // sent its request
+   if(upgradeClientFd != -1)
+   {
+      LOG("Refused a handoff\n\r");
+      closeUpgradeClient();
+   }
+   upgradeClientFd = fd;
+   watchEvents(fd, EPOLLIN, EPOLL_CTL_ADD);
+}
+
+/*
+ * Stop watching and close the connection from a new serkey
+ */
+local void closeUpgradeClient(void)
+{
+   // If the event loop is still running (stopUring() ends io_uring)...
+   if(uring.fd != -1 || epollFd != -1)
+      watchEvents(upgradeClientFd, 0, EPOLL_CTL_DEL);
+   close(upgradeClientFd);
+   upgradeClientFd = -1;
+}
+
+/*
+ * Hand the serial port and output to the new serkey connected to the
+ * upgrade socket, then exit without destroying the virtual keyboard or
+ * restoring the serial port. Bytes not read yet stay in the driver for the
+ * new serkey. If started by systemd, the notify socket goes with them and
+ * the new serkey becomes the service's main process
+ */
+local void handOff(void)
+{
+   handoff_t            state;
+   int                  fd = upgradeClientFd, fds[3] = {ttyFd, outputFd, notifyFd};
+   size_t               fdCount = (notifyFd != -1)?3:2;
+   union {
+      char              buffer[CMSG_SPACE(sizeof(fds))];
+      struct cmsghdr    align;
+   }                    control;
+   struct iovec         iov = {.iov_base = &state, .iov_len = sizeof(state)};
+   struct msghdr        msg = {.msg_iov = &iov, .msg_iovlen = 1, .msg_control = control.buffer, .msg_controllen = CMSG_SPACE(fdCount * sizeof(int))};
+   struct cmsghdr       *cmsg;
+   char                 mainPid[32];
+   ssize_t              ret;
+   pid_t                pid;
+
+   // If the request hasn't arrived yet, wait for it
+   if((ret = recv(fd, &state, sizeof(state), MSG_DONTWAIT)) < 0 && (errno == EAGAIN || errno == EINTR))
+      return;
+
+   // If not a request for this serkey's output, keep running
+   if(ret != sizeof(state) || state.magic != HANDOFF_MAGIC || state.output != (int)appConfig.output)
+   {
+      LOG("Refused a handoff\n\r");
+      closeUpgradeClient();
+      return;
+   }
+   pid = state.pid;
+   LOG("Handing off to the new serkey\n\r");
+
+   // Stop reading the serial port, map the keys already read, and write
+   // their events
+   stopSerialReads(ttyFd);
+   flushFrame(outputFd);
+   stopUring();
+   drainPending(outputFd);
+   throttleSerial(false);
+
+   memset(&state, 0, sizeof(state));
+   state.magic = HANDOFF_MAGIC;
+   state.output = (int)appConfig.output;
+   state.watchdogMs = watchdogMs;
+   state.ttyConfig = ttyConfig;
+   memcpy(state.heldKeys, heldKeys, sizeof(heldKeys));
+   state.frameState = frameState;
+   state.frameAddress = frameDevice?frameDevice->address:-1;
+
+   cmsg = CMSG_FIRSTHDR(&msg);
+   cmsg->cmsg_level = SOL_SOCKET;
+   cmsg->cmsg_type = SCM_RIGHTS;
+   cmsg->cmsg_len = CMSG_LEN(fdCount * sizeof(int));
+   memcpy(CMSG_DATA(cmsg), fds, fdCount * sizeof(int));
+
+   if(sendmsg(fd, &msg, MSG_NOSIGNAL) != sizeof(state))
+      exitApp("Unable to hand off to the new serkey", false, -42);
+   closeUpgradeClient();
+
+   // Tell systemd the new serkey is the main process, so this one exiting
+   // doesn't restart the service
+   snprintf(mainPid, sizeof(mainPid), "MAINPID=%d", (int)pid);
+   notifySystemd(mainPid);
+
+   // The new serkey owns the devices and the sockets
+   ttyFd = 0;
+   outputFd = -1;
+   close(upgradeFd);
+   upgradeFd = -1;
+   if(metricsFd != -1)
+      close(metricsFd);
+   metricsFd = -1;
+   exitApp("Handed off to the new serkey", false, 0);
+}
+
+/*
+ * Stop reading the serial port and map the keys already read, so no byte is
+ * read by both serkeys or lost between them
+ */
+local void stopSerialReads(int fd)
+{
+   // If reading in a separate thread, stop it once it's waiting for the
+   // port. Free the queue so it isn't waiting for space, then map the rest
+   if(appConfig.threads)
+   {
+      uint64_t stop = 1;
+
+      if(write(keyQueue.stopFd, &stop, sizeof(stop)) < 0)
+         exitApp("Unable to stop the reader thread", false, -33);
+      readQueue(outputFd);
+      pthread_join(readerThread, NULL);
+      readQueue(outputFd);
+   }
+   // Else if using io_uring, cancel the read armed on the port
+   else if(uring.fd != -1)
+      cancelSerialRead(fd);
+   // Else epoll only reads the port when it's dispatched
+}
+
+/*
+ * Cancel the io_uring read of the serial port, mapping the keys if it
+ * completed first. Other completions are dropped, serkey is exiting
+ */
+local void cancelSerialRead(int fd)
+{
+   struct io_uring_sqe  *sqe;
+   uringcqe_t           cqe;
+   bool                 reading = true;
+
+   // Cancel the poll and the read linked to it
+   sqe = getSqe(fd, URING_CANCEL);
+   sqe->opcode = IORING_OP_ASYNC_CANCEL;
+   sqe->addr = ((uint64_t)URING_POLL << 32) | (uint32_t)fd;
+   sqe = getSqe(fd, URING_CANCEL);
+   sqe->opcode = IORING_OP_ASYNC_CANCEL;
+   sqe->addr = ((uint64_t)URING_READ << 32) | (uint32_t)fd;
+
+   // Wait for the read to complete or be cancelled
+   while(reading)
+   {
+      submitUring(true);
+      while(nextCqe(&cqe))
+      {
+         switch((uringop_t)(cqe.user_data >> 32))
+         {
+            case URING_READ:
+               reading = false;
+               if(cqe.res > 0)
+                  processKeys(uringBuffer, cqe.res, monotonicTime(), outputFd);
+               break;
+            case URING_WRITE:
+               onUringCompletion(&cqe);
+               break;
+            default:
+               break;
+         }
+      }
+   }
+}
+
+// Systemd Functions **********************************************************
+/*
+ * Connect to the systemd notify socket named by NOTIFY_SOCKET and read the
+ * watchdog period from WATCHDOG_USEC. Speaks the notify protocol directly so
+ * libsystemd isn't required
+ */
+local void connectNotify(void)
+{
+   struct sockaddr_un   addr;
+   char                 *path = getenv("NOTIFY_SOCKET");
+   char                 *usec = getenv("WATCHDOG_USEC");
+   char                 *pid = getenv("WATCHDOG_PID");
+   socklen_t            length;
+
+   // If the serkey that handed off passed its notify socket...
+   if(notifyFd != -1)
+   {
+      LOG("Took over the systemd notify socket, watchdog: %d ms\n\r", watchdogMs);
+      return;
+   }
+
+   // If not started by systemd with Type=notify...
+   if(path == NULL || (path[0] != '/' && path[0] != '@') || strlen(path) >= sizeof(addr.sun_path))
+      return;
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+   // If abstract socket, replace the @ with a nul
+   if(path[0] == '@')
+      addr.sun_path[0] = '\0';
+   length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + strlen(path));
+
+   if((notifyFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0)) == -1)
+      exitApp("Unable to create the systemd notify socket", false, -28);
+   if(connect(notifyFd, (struct sockaddr *)&addr, length))
+      exitApp("Unable to connect to the systemd notify socket", false, -28);
+
+   // If the watchdog is enabled for this process...
+   if(usec && (pid == NULL || atoi(pid) == getpid()))
+      watchdogMs = (int)(strtoull(usec, NULL, 10) / 1000);
+
+   LOG("Connected to systemd notify socket, watchdog: %d ms\n\r", watchdogMs);
+}
+
+/*
+ * Send a state update to systemd
+ */
+local void notifySystemd(const char *state)
+{
+   // If not started by systemd...
+   if(notifyFd == -1)
+      return;
+
+   if(send(notifyFd, state, strlen(state), MSG_NOSIGNAL) < 0)
+      LOG("Unable to notify systemd: %s\n\r", strerror(errno));
+}
+
+// Event Loop Functions *******************************************************
+/*
+ * Add or modify the events watched for a file descriptor
+ */
+local void watchEvents(int fd, unsigned int events, int op)
+{
+   struct epoll_event ev;
+
+   // If using io_uring...
+   if(uring.fd != -1)
+   {
+      // If adding the serial port, start reading it
+      if(op == EPOLL_CTL_ADD && fd == ttyFd)
+         armSerialRead(fd);
+      // Else if adding another file descriptor, poll it until removed
+      else if(op == EPOLL_CTL_ADD)
+         armWatch(fd, events);
+      // Else if removing a file descriptor, cancel its poll
+      else if(op == EPOLL_CTL_DEL)
+      {
+         struct io_uring_sqe *sqe = getSqe(fd, URING_CANCEL);
+
+         sqe->opcode = IORING_OP_POLL_REMOVE;
+         sqe->addr = ((uint64_t)URING_WATCH << 32) | (uint32_t)fd;
+      }
+      // Else if waiting for the serial port to be writable, poll once
+      else if(events & EPOLLOUT)
+         getSqe(fd, URING_POLLOUT)->poll32_events = POLLOUT;
+      return;
+   }
+
+   memset(&ev, 0, sizeof(ev));
+   ev.events = events;
+   ev.data.fd = fd;
+
+   if(epoll_ctl(epollFd, op, fd, &ev))
+      exitApp("Unable to watch file descriptor events", false, -21);
+}
+
+/*
+ * Handle a file descriptor that is ready
+ */
+local void dispatchEvent(int fd, unsigned int events)
+{
+   // If the serial port is ready...
+   if(fd == ttyFd)
+   {
+      if(serialEvents && (events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+         readSerial(ttyFd, outputFd);
+      if(events & EPOLLOUT)
+         flushSerial(ttyFd);
+   }
+   // Else if the output is ready...
+   else if(fd == outputFd)
+   {
+      if(events & (EPOLLOUT | EPOLLERR))
+         flushPending(outputFd);
+      if(outputEvents && (events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+         readUinput(outputFd, ttyFd);
+   }
+   // Else if the reader thread queued keys...
+   else if(fd == keyQueue.dataFd)
+      readQueue(outputFd);
+   // Else if the timer expired...
+   else if(fd == timerFd)
+      onTimer(ttyFd);
+   // Else if a new serkey is taking over...
+   else if(fd == upgradeFd)
+      acceptUpgrade();
+   // Else if its request arrived...
+   else if(fd == upgradeClientFd)
+      handOff();
+   // Else if the metrics are being scraped...
+   else if(fd == metricsFd)
+      serveMetrics();
+   // Else if a signal was received...
+   else if(fd == signalFd)
+      onSignal();
+}
+
+/*
+ * Create the event loop timer that expires every periodMs
+ */
+local int createTimer(int periodMs)
+{
+   struct itimerspec tick;
+   int               fd;
+
+   if((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))<0)
+      exitApp("Unable to create the event loop timer", false, -22);
+
+   // A zero period would disarm the timer
+   if(periodMs < 1)
+      periodMs = 1;
+
+   tick.it_interval.tv_sec = periodMs / 1000;
+   tick.it_interval.tv_nsec = (periodMs % 1000) * 1000000L;
+   tick.it_value = tick.it_interval;
+   repeat.tickNs = (uint64_t)periodMs * 1000000ULL;
+   repeat.tick = monotonicTime() + repeat.tickNs;
+
+   if(timerfd_settime(fd, 0, &tick, NULL))
+      exitApp("Unable to start the event loop timer", false, -22);
+
+   return(fd);
+}
+
+/*
+ * Handle the event loop timer expiring
+ */
+local void onTimer(int serialFd)
+{
+   uint64_t expirations;
+
+   // Acknowledge the timer
+   if(read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations))
+      return;
+
+   // If autorepeating, the timer is set for the next repeat or tick,
+   // whichever is first. Repeat the held key, and if it isn't time for the
+   // tick yet, wait for it
+   if(appConfig.repeatDelayNs)
+   {
+      uint64_t now = monotonicTime();
+      bool     tick = now >= repeat.tick;
+
+      if(repeat.key != KEY_RESERVED && repeat.next && now >= repeat.next)
+         repeatKey(now);
+      if(tick)
+         repeat.tick = now + repeat.tickNs;
+      scheduleTimer();
+      if(!tick)
+         return;
+   }
+
+   // Poll the serial driver error counters
+   if(appConfig.errors != ERRORS_IGNORE)
+      pollSerialErrors(serialFd);
+
+   // The event loop is running, ping the systemd watchdog
+   if(watchdogMs)
+      notifySystemd("WATCHDOG=1");
+
+   // Publish the counters updated outside the key path
+   if(statsPage)
+      publishStats(monotonicTime());
+   if(appConfig.metrics == METRICS_FILE)
+      writeMetricsFile();
+}
+
+/*
+ * Returns true for the modifier and lock keys, which don't autorepeat
+ */
+local bool isModifier(int code)
+{
+   switch(code)
+   {
+      case KEY_LEFTCTRL: case KEY_RIGHTCTRL:
+      case KEY_LEFTSHIFT: case KEY_RIGHTSHIFT:
+      case KEY_LEFTALT: case KEY_RIGHTALT:
+      case KEY_LEFTMETA: case KEY_RIGHTMETA:
+      case KEY_CAPSLOCK: case KEY_NUMLOCK: case KEY_SCROLLLOCK:
+         return(true);
+      default:
+         return(false);
+   }
+}
+
+/*
+ * Schedule the first repeat of the key just made, the delay after it was
+ * read
+ */
+local void startRepeat(uint64_t time)
+{
+   repeat.next = time + appConfig.repeatDelayNs;
+   scheduleTimer();
+}
+
+/*
+ * Send an autorepeat of the held key, as the input core does for EV_REP,
+ * and schedule the next one. If the event loop fell behind, the missed
+ * repeats are skipped rather than sent in a burst
+ */
+local void repeatKey(uint64_t now)
+{
+   LOG("  Repeat - Key %03d\n\r", repeat.key);
+
+   emit(outputFd, EV_KEY, repeat.key, 2);
+   emit(outputFd, EV_SYN, SYN_REPORT, 0);
+   flushFrame(outputFd);
+   ++stats.repeats;
+
+   repeat.next += appConfig.repeatPeriodNs;
+   if(repeat.next <= now)
+      repeat.next = now + appConfig.repeatPeriodNs;
+}
+
+/*
+ * Set the timer for the next repeat of the held key or the next tick,
+ * whichever is first
+ */
+local void scheduleTimer(void)
+{
+   struct itimerspec when;
+   uint64_t          deadline = repeat.tick;
+
+   if(repeat.key != KEY_RESERVED && repeat.next && repeat.next < deadline)
+      deadline = repeat.next;
+
+   memset(&when, 0, sizeof(when));
+   when.it_value.tv_sec = (time_t)(deadline / NS_PER_SEC);
+   when.it_value.tv_nsec = (long)(deadline % NS_PER_SEC);
+   if(timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &when, NULL))
+      exitApp("Unable to schedule the event loop timer", false, -22);
+}
+
+/*
+ * Block the signals handled by the event loop and return a signalfd that
+ * reports them
+ */
+local int createSignals(void)
+{
+   sigset_t mask;
+   int      fd;
+
+   sigemptyset(&mask);
+   sigaddset(&mask, SIGUSR1);
+   sigaddset(&mask, SIGUSR2);
+   sigaddset(&mask, SIGTERM);
+   sigaddset(&mask, SIGINT);
+   sigaddset(&mask, SIGHUP);
+
+   if(sigprocmask(SIG_BLOCK, &mask, NULL))
+      exitApp("Unable to block signals", false, -23);
+   if((fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC))<0)
+      exitApp("Unable to create the signal file descriptor", false, -23);
+
+   return(fd);
+}
+
+/*
+ * Handle the signals received by the event loop
+ */
+local void onSignal(void)
+{
+   struct signalfd_siginfo info;
+
+   // For each pending signal...
+   while(read(signalFd, &info, sizeof(info)) == sizeof(info))
+   {
+      // Display the statistics
+      if(info.ssi_signo == SIGUSR1)
+         dumpStats(stdout);
+      // Display the per-key counts
+      else if(info.ssi_signo == SIGUSR2)
+         dumpKeyCounts(stdout);
+      // Else shut down, releasing the keys, removing the output, and
+      // restoring the serial port
+      else
+      {
+         LOG("Received signal %d, shutting down\n\r", (int)info.ssi_signo);
+         notifySystemd("STOPPING=1");
+         exitApp(NULL, false, 0);
+      }
+   }
+}
+
+/*
+ * Create the stats page. It's written to a new file renamed over the path,
+ * so a serkey that handed off keeps updating its own page until it exits
+ */
+local void createStatsPage(char *path)
+{
+   char        temp[PATH_MAX], *slash;
+   statspage_t *page;
+   int         fd;
+
+   if(snprintf(temp, sizeof(temp), "%s.%d", path, (int)getpid()) >= (int)sizeof(temp))
+      exitApp("Stats page path is too long", false, -43);
+
+   // Create the directory, /run/serkey, if it's missing
+   if((slash = strrchr(temp, '/')) != NULL && slash != temp)
+   {
+      *slash = '\0';
+      mkdir(temp, 0755);
+      *slash = '/';
+   }
+
+   if((fd = open(temp, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) == -1 ||
+      ftruncate(fd, sizeof(*page)) ||
+      (page = mmap(NULL, sizeof(*page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED ||
+      rename(temp, path))
+      exitApp("Unable to create the stats page", false, -43);
+   close(fd);
+
+   page->magic = STATS_MAGIC;
+   page->version = STATS_VERSION;
+   page->pid = (int32_t)getpid();
+
+   // Count each keypad's bytes and the latencies in the page from now on
+   page->keypads = busDevices + 1;
+   for(int i=0;i<=BUS_DEVICES;++i)
+   {
+      page->addresses[i] = devices[i].address;
+      memcpy(page->keyCounts[i], devices[i].keyCounts, sizeof(page->keyCounts[i]));
+      devices[i].keyCounts = page->keyCounts[i];
+   }
+   memcpy(page->latency, latency, sizeof(page->latency));
+   latency = page->latency;
+   statsPage = page;
+   publishStats(monotonicTime());
+   LOG("Publishing stats to %s\n\r", path);
+}
+
+/*
+ * Publish the final stats and mark the page as no longer updated
+ */
+local void closeStatsPage(void)
+{
+   // If not publishing stats...
+   if(statsPage == NULL)
+      return;
+
+   publishStats(monotonicTime());
+   __atomic_store_n(&statsPage->pid, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * Copy the counters to the stats page under its seqlock. Only memory is
+ * written, no system calls or locks
+ */
+local void publishStats(uint64_t now)
+{
+   statspage_t *page = statsPage;
+
+   // Make the sequence odd while the counters change
+   __atomic_store_n(&page->sequence, page->sequence + 1, __ATOMIC_RELAXED);
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+
+   page->updated = now;
+   page->keys = stats.keys;
+   page->marked = stats.marked;
+   page->dropped = stats.dropped;
+   page->breaks = stats.breaks;
+   page->suppressed = stats.suppressed;
+   page->waits = stats.waits;
+   page->feedbackDropped = txQueue.dropped;
+   page->frames = stats.frames;
+   page->frameErrors = stats.frameErrors;
+   page->unknownAddress = stats.unknownAddress;
+   page->outputStalls = pending.stalls;
+   page->outputStallMaxNs = pending.stallMax;
+   page->outputStallTotalNs = pending.stallTotal;
+   page->outputPendingHighWater = pending.highWater / sizeof(struct input_event);
+   page->outputDropped = pending.dropped;
+   page->throttles = stats.throttles;
+   page->queueHighWater = __atomic_load_n(&keyQueue.highWater, __ATOMIC_RELAXED);
+   page->queueDelayMaxNs = stats.queueDelayMax;
+   page->rx = (uint64_t)stats.icount.rx;
+   page->overrun = (uint64_t)stats.icount.overrun;
+   page->bufOverrun = (uint64_t)stats.icount.buf_overrun;
+   page->parity = (uint64_t)stats.icount.parity;
+   page->frame = (uint64_t)stats.icount.frame;
+   page->brk = (uint64_t)stats.icount.brk;
+
+   // Make the sequence even once they're consistent
+   __atomic_store_n(&page->sequence, page->sequence + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Count keys in the latency bucket for the time from when they were read to
+ * when their events were written
+ */
+local void recordLatency(uint64_t now, uint64_t time, uint64_t keys)
+{
+   uint64_t micros = (now - time) / 1000;
+   int      bucket = 0;
+
+   // Bucket i counts latencies under 2^i microseconds
+   while(bucket < STATS_LATENCY_BUCKETS - 1 && micros >= (1ULL << bucket))
+      ++bucket;
+
+   __atomic_store_n(&latency[bucket], __atomic_load_n(&latency[bucket], __ATOMIC_RELAXED) + keys, __ATOMIC_RELAXED);
+   latencySum += (now - time) * keys;
+}
+
+// Metrics Functions **********************************************************
+/*
+ * Listen on the metrics socket, or open the directory of the metrics file
+ * and name the temporary file the metrics are written to before they're
+ * renamed over it
+ */
+local void startMetrics(char *path)
+{
+   struct sockaddr_un   addr;
+   char                 dir[PATH_MAX];
+
+   // If writing a file...
+   if(appConfig.metrics == METRICS_FILE)
+   {
+      // Split the directory from the name
+      if((metricsName = strrchr(path, '/')) == NULL)
+      {
+         metricsName = path;
+         strcpy(dir, ".");
+      }
+      else if(snprintf(dir, sizeof(dir), "%.*s", (metricsName == path)?1:(int)(metricsName - path), path) >= (int)sizeof(dir))
+         exitApp("Metrics file path is too long", false, -44);
+      else
+         ++metricsName;
+      if(*metricsName == '\0')
+      {
+         errno = EINVAL;
+         exitApp("Invalid metrics file path", false, -44);
+      }
+      if(snprintf(metricsTemp, sizeof(metricsTemp), "%s.%d", metricsName, (int)getpid()) >= (int)sizeof(metricsTemp))
+         exitApp("Metrics file name is too long", false, -44);
+
+      // Open the directory now, its path may not be searchable after
+      // privileges are dropped
+      if((metricsDirFd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1)
+         exitApp("Unable to open the metrics file directory", false, -44);
+      LOG("Writing metrics to %s\n\r", path);
+      return;
+   }
+
+   if(strlen(path) >= sizeof(addr.sun_path))
+      exitApp("Metrics socket path is too long", false, -44);
+
+   if((metricsFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1)
+      exitApp("Unable to create the metrics socket", false, -44);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+
+   unlink(path);
+   if(bind(metricsFd, (struct sockaddr *)&addr, sizeof(addr)) || listen(metricsFd, 4))
+      exitApp("Unable to listen on the metrics socket", false, -44);
+
+   watchEvents(metricsFd, EPOLLIN, EPOLL_CTL_ADD);
+   LOG("Serving metrics on %s\n\r", path);
+}
+
+/*
+ * Send the metrics to a scraper connecting to the metrics socket. The send
+ * doesn't wait, a scraper that can't take them all gets what fits
+ */
+local void serveMetrics(void)
+{
+   int fd;
+
+   if((fd = accept(metricsFd, NULL, NULL)) == -1)
+      return;
+
+   formatMetrics();
+   if(send(fd, metricsBuffer.data, metricsBuffer.length, MSG_NOSIGNAL | MSG_DONTWAIT) < 0)
+      LOG("Unable to send the metrics\n\r");
+   close(fd);
+}
+
+/*
+ * Give an existing metrics file to the user privileges are dropped to. Root
+ * may own it from an earlier run, and a file owned by someone else can't be
+ * replaced in a sticky directory
+ */
+local void chownMetricsFile(uid_t uid, gid_t gid)
+{
+   if(fchownat(metricsDirFd, metricsName, uid, gid, AT_SYMLINK_NOFOLLOW) && errno != ENOENT)
+      exitApp("Unable to give the metrics file to the user", false, -44);
+}
+
+/*
+ * Write the metrics to a temporary file and rename it over the metrics
+ * file, so the collector never reads part of them. The first failure after
+ * a success is reported, since the collector keeps reading the old metrics.
+ * Returns false if not written
+ */
+local bool writeMetricsFile(void)
+{
+   int      fd, error;
+   ssize_t  length;
+   bool     written;
+
+   formatMetrics();
+
+   if((fd = openat(metricsDirFd, metricsTemp, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0644)) != -1)
+   {
+      length = write(fd, metricsBuffer.data, metricsBuffer.length);
+      written = length == (ssize_t)metricsBuffer.length;
+      error = (length < 0)?errno:ENOSPC;
+      close(fd);
+
+      // If written, replace the metrics...
+      if(written && renameat(metricsDirFd, metricsTemp, metricsDirFd, metricsName) == 0)
+      {
+         if(metricsFailed)
+            LOG("Writing the metrics file again\n\r");
+         metricsFailed = false;
+         return(true);
       }
-      // Else update the device path/name 
-      else
-         appConfig.tty = argv[i];
+      if(written)
+         error = errno;
+      unlinkat(metricsDirFd, metricsTemp, 0);
+      errno = error;
    }
 
-   if(appConfig.tty==NULL)
-      exitApp("No serial device provided", true, -11);
+   // If it was working, report the metrics are now stale
+   if(!metricsFailed)
+   {
+      fprintf(stderr, "Unable to write the metrics file %s: %s\n\r", appConfig.metricsPath, strerror(errno));
+      fflush(stderr);
+   }
+   metricsFailed = true;
+   return(false);
 }
 
 /*
- * Display the application usage w/command line options and exit w/error
+ * Append to the metrics buffer. Metrics that don't fit are left out
  */
-local void displayUsage(FILE *output_stream)
+local void appendMetrics(const char *format, ...)
 {
-   fprintf(output_stream, "Usage: serkey [OPTION]... serial_device\n\n\r"
-          "serkey is a user mode serial keyboard driver for Linux. It utilizes the uinput\n\r"
-          "kernel module and tio serial device I/O tool. Therefore, both must be installed\n\r"
-          "and enabled. In addition, serkey must be run at a priviledge level capable of\n\r"
-          "communicating with uinput. On most distributions, this is root level priviledges\n\r"
-          "by default. The serial_device specifies the \\dev tty device connected to the \n\r"
-          "keyboard.\n\n\r"
-          "OPTIONS:\n\r"
-          "  -b   <bps>\n\r"
-          "       Set the baud rate in bits per second (bps) (default:300)\n\r"
-          "  -p   odd|even|none|mark|space\n\r"
-          "       Set the parity  (default:none)\n\r"
-          "  -d   5|6|7|8|9\n\r"
-          "       Set the number of data bits (default:8)\n\r"
-          "  -s   1|2\n\r"
-          "       Set the number of stop bits (default:1)\n\r"
-          "  -k   kaypro|media_keys|ascii\n\r"
-          "       Select the key mapping (default:kaypro)\n\r"
-          "  -f   Fork and exit creating daemon process\n\r"
-          "  -v   Verbose output to stdout/stderr\n\r"
-          "  -h   Display this usage information\n\r");
+   va_list  args;
+   int      length;
+   size_t   space = sizeof(metricsBuffer.data) - metricsBuffer.length;
+
+   va_start(args, format);
+   length = vsnprintf(metricsBuffer.data + metricsBuffer.length, space, format, args);
+   va_end(args);
+
+   // If it didn't fit, drop the partial line
+   if(length < 0 || (size_t)length >= space)
+      metricsBuffer.data[metricsBuffer.length] = '\0';
+   else
+      metricsBuffer.length += (size_t)length;
 }
 
 /*
- * Display a message and exit the application with a given return code
+ * Append the HELP and TYPE lines of a metric
  */
-local void exitApp(char* error_str, bool display_usage, int return_code)
+local void appendMetricHeader(const char *name, const char *type, const char *help)
 {
-   FILE *output;
-
-   // If the serial port has already been configured...
-   if(ttyFd>0)
-      closeSerial(ttyFd);
-
-   // Is the return code an error...
-   if(return_code)
-      output = stderr;
-   else
-      output = stdout;
-
-   // If an error string was provided...
-   if(error_str)
-      if(strlen(error_str))
-         fprintf(output, "%s %s\n\r%s %s\n\r",  return_code?"Error:":"OK:", 
-                                       error_str, 
-                                       return_code?"Error Code -":"", 
-                                       return_code?strerror(errno):"");
-
-   if(display_usage == true)
-      displayUsage(output);
-
-   fflush(output);
-   exit(return_code);
+   appendMetrics("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
 }
 
-// Uinput interface functions *************************************************
 /*
- * Emit an event to the uinput virtual device 
+ * Append a counter or gauge without labels
  */
-local void emit(int fd, int type, int code, int val)
+local void appendMetric(const char *name, const char *type, const char *help, double value)
 {
-   struct input_event ie;
+   appendMetricHeader(name, type, help);
+   appendMetrics("%s %.9g\n", name, value);
+}
 
-   ie.type = type;
-   ie.code = code;
-   ie.value = val;
-   // timestamp values below are ignored
-   ie.time.tv_sec = 0;
-   ie.time.tv_usec = 0;
+/*
+ * Append a counter with a value for each keypad
+ */
+local void appendKeypadMetric(const char *name, const char *help, size_t offset)
+{
+   appendMetricHeader(name, "counter", help);
 
-   int ret = write(fd, &ie, sizeof(ie));
+   // For each keypad, the serial port's only keypad if not on a bus...
+   for(int i=busDevices?1:0;i<=busDevices;++i)
+   {
+      device_t       *device = &devices[i];
+      unsigned long  value = *(unsigned long *)(void *)((char *)device + offset);
 
-   if(ret != sizeof(ie))
-      exitApp("Failed to write to uintput\n\r", false, -12);
+      if(busDevices)
+         appendMetrics("%s{keypad=\"%d\",key_map=\"%s\"} %lu\n", name, device->address, deviceKeymapName(device), value);
+      else
+         appendMetrics("%s{keypad=\"serial\",key_map=\"%s\"} %lu\n", name, deviceKeymapName(device), value);
+   }
 }
 
 /*
- * Emit a key press to uinput
+ * Format the metrics in the Prometheus text exposition format. Runs when
+ * scraped or once a second, never on the key path
  */
-local void emitKey(int fd, keymap_t *key)
+local void formatMetrics(void)
 {
+   uint64_t count = 0;
 
-   LOG("  Out - ");
-   
-   // If control key required...
-   if(key->control)
+   metricsBuffer.length = 0;
+   metricsBuffer.data[0] = '\0';
+
+   // Keys by keypad and key map
+   appendKeypadMetric("serkey_keys_total", "Keys accepted from the keypad.", offsetof(device_t, keys));
+   appendKeypadMetric("serkey_keys_unmapped_total", "Keys without a key in the key map.", offsetof(device_t, unmapped));
+   appendKeypadMetric("serkey_keys_rate_limited_total", "Keys dropped by the rate limit.", offsetof(device_t, limited));
+   appendKeypadMetric("serkey_keypad_quarantines_total", "Times the keypad was quarantined.", offsetof(device_t, quarantines));
+   appendKeypadMetric("serkey_keypad_quarantined_bytes_total", "Bytes dropped while the keypad was quarantined.", offsetof(device_t, quarantined));
+   appendMetric("serkey_keys_suppressed_total", "counter", "Repeated keys dropped by the debounce filter.", (double)stats.suppressed);
+
+   // Serial errors
+   appendMetric("serkey_serial_marked_total", "counter", "Bytes marked with a parity or framing error.", (double)stats.marked);
+   appendMetric("serkey_serial_marked_dropped_total", "counter", "Marked bytes dropped.", (double)stats.dropped);
+   appendMetric("serkey_serial_breaks_total", "counter", "Break conditions marked in-band.", (double)stats.breaks);
+   if(stats.icountValid)
    {
-      LOG("Ctrl: Make ");
-      // Control key make, report the event
-      emit(fd, EV_KEY, KEY_LEFTCTRL, 1);
-      emit(fd, EV_SYN, SYN_REPORT, 0);
+      appendMetricHeader("serkey_serial_errors_total", "counter", "Serial driver error counters.");
+      appendMetrics("serkey_serial_errors_total{type=\"overrun\"} %d\n", stats.icount.overrun);
+      appendMetrics("serkey_serial_errors_total{type=\"buf_overrun\"} %d\n", stats.icount.buf_overrun);
+      appendMetrics("serkey_serial_errors_total{type=\"parity\"} %d\n", stats.icount.parity);
+      appendMetrics("serkey_serial_errors_total{type=\"frame\"} %d\n", stats.icount.frame);
+      appendMetrics("serkey_serial_errors_total{type=\"break\"} %d\n", stats.icount.brk);
    }
-   else
-      LOG("Ctrl: N/A  ");
-   // If shift key required...
-   if(key->shift)
+   if(busDevices)
    {
-      LOG("Shift: Make ");
-      // Shift key make, report the event
-      emit(fd, EV_KEY, KEY_LEFTSHIFT, 1);
-      emit(fd, EV_SYN, SYN_REPORT, 0);
+      appendMetric("serkey_bus_frames_total", "counter", "Bus frames received.", (double)stats.frames);
+      appendMetric("serkey_bus_frame_errors_total", "counter", "Bytes outside a bus frame or invalid escapes.", (double)stats.frameErrors);
+      appendMetric("serkey_bus_unknown_address_total", "counter", "Bus frames from an address without a keypad.", (double)stats.unknownAddress);
    }
-   else
-      LOG("Shift: N/A  ");
 
-   // If make/break required...
-   if(key->makebreak)
+   // Output stalls and queues
+   appendMetric("serkey_output_stalls_total", "counter", "Times the output stopped accepting events.", (double)pending.stalls);
+   appendMetric("serkey_output_stall_seconds_total", "counter", "Time the output wasn't accepting events.", (double)pending.stallTotal / 1e9);
+   appendMetric("serkey_output_stall_max_seconds", "gauge", "Longest the output wasn't accepting events.", (double)pending.stallMax / 1e9);
+   appendMetric("serkey_output_pending", "gauge", "Events waiting for the output.", (double)((pending.end - pending.start) / sizeof(struct input_event)));
+   appendMetric("serkey_output_pending_high_water", "gauge", "Most events that waited for the output.", (double)(pending.highWater / sizeof(struct input_event)));
+   appendMetric("serkey_output_dropped_total", "counter", "Events dropped because the output queue was full.", (double)pending.dropped);
+   appendMetric("serkey_rts_throttles_total", "counter", "Times RTS was deasserted because the output was behind.", (double)stats.throttles);
+   appendMetric("serkey_feedback_dropped_total", "counter", "Feedback bytes dropped because the serial queue was full.", (double)txQueue.dropped);
+   if(appConfig.threads)
    {
-      LOG("MB: 1 Key %03d ",key->key);
-      // Key make, report the event
-      emit(fd, EV_KEY, key->key, 1);
-      emit(fd, EV_SYN, SYN_REPORT, 0);
-      // Key break, report the event
-      emit(fd, EV_KEY, key->key, 0);
-      emit(fd, EV_SYN, SYN_REPORT, 0);
+      appendMetric("serkey_queue_depth", "gauge", "Keys in the reader thread queue.",
+                   (double)(__atomic_load_n(&keyQueue.head, __ATOMIC_ACQUIRE) - keyQueue.tail));
+      appendMetric("serkey_queue_high_water", "gauge", "Most keys in the reader thread queue.", (double)__atomic_load_n(&keyQueue.highWater, __ATOMIC_RELAXED));
    }
-   // Else just make or break according the MSB...
-   else
+   appendMetric("serkey_event_loop_waits_total", "counter", "epoll_wait or io_uring_enter calls.", (double)stats.waits);
+
+   // Latency histogram, the buckets are cumulative
+   appendMetricHeader("serkey_key_latency_seconds", "histogram", "Time from reading a key to writing its events.");
+   for(int i=0;i<STATS_LATENCY_BUCKETS - 1;++i)
    {
-      LOG("MB: 0 Key %03d ",key->key);
-      // Key make or break, report the event
-      emit(fd, EV_KEY, key->key && 0x7f, (key->key && 0x80) >> 7);
-      emit(fd, EV_SYN, SYN_REPORT, 0);
+      count += __atomic_load_n(&latency[i], __ATOMIC_RELAXED);
+      appendMetrics("serkey_key_latency_seconds_bucket{le=\"%g\"} %llu\n", (double)(1ULL << i) / 1e6, (unsigned long long)count);
    }
+   count += __atomic_load_n(&latency[STATS_LATENCY_BUCKETS - 1], __ATOMIC_RELAXED);
+   appendMetrics("serkey_key_latency_seconds_bucket{le=\"+Inf\"} %llu\n", (unsigned long long)count);
+   appendMetrics("serkey_key_latency_seconds_sum %.9g\n", (double)latencySum / 1e9);
+   appendMetrics("serkey_key_latency_seconds_count %llu\n", (unsigned long long)count);
+}
 
-   // If control key required...
-   if(key->control)
+/*
+ * Open the perf_event counters for the event loop thread. If the CPU has no
+ * PMU, as in many VMs, task-clock replaces cycles and the other hardware
+ * counters are skipped. The cost of reading the counters is measured so it
+ * can be subtracted from each batch
+ */
+local void startProfile(void)
+{
+   uint64_t start[PROFILE_COUNTERS], end[PROFILE_COUNTERS];
+
+   // For each counter...
+   for(int i=0;i<sizeof(profileCounters)/sizeof(profileCounters[0]);++i)
    {
-      LOG("CTRL: break");
-      // Control key break, report the event
-      emit(fd, EV_KEY, KEY_LEFTCTRL, 0);
-      emit(fd, EV_SYN, SYN_REPORT, 0);
+      const profilecounter_t  *counter = &profileCounters[i];
+      int                     fd;
+
+      // task-clock only replaces cycles
+      if(counter->config == PERF_COUNT_SW_TASK_CLOCK && counter->type == PERF_TYPE_SOFTWARE && !profile.software)
+         continue;
+
+      if((fd = openCounter(counter)) == -1)
+      {
+         // If the hardware counter isn't available, skip it
+         if(counter->type == PERF_TYPE_HARDWARE)
+         {
+            if(counter->config == PERF_COUNT_HW_CPU_CYCLES)
+               profile.software = true;
+            continue;
+         }
+         exitApp("Unable to open the profiling counters", false, -45);
+      }
+
+      // The first counter opened leads the group, so they're read together
+      if(profile.fd == -1)
+         profile.fd = fd;
+      profile.counters[profile.count++] = counter;
    }
-   // If shift key required...
-   if(key->shift)
+
+   // Measure the counts of reading the counters back to back. Keep the
+   // least, as a context switch can land in any of them
+   for(int i=0;i<PROFILE_CALIBRATE;++i)
    {
-      LOG("SHIFT: break");
-      // Shift key break, report the event
-      emit(fd, EV_KEY, KEY_LEFTSHIFT, 0);
-      emit(fd, EV_SYN, SYN_REPORT, 0);
+      readCounters(start);
+      readCounters(end);
+      for(int j=0;j<profile.count;++j)
+         if(i == 0 || end[j] - start[j] < profile.overhead[j])
+            profile.overhead[j] = end[j] - start[j];
    }
 
-   LOG("\n\r");
+   LOG("Profiling with %s counters%s\n\r", profile.software?"software":"hardware",
+       profile.userOnly?", user space only":"");
 }
 
 /*
- * Connect to the uinput kernel module
+ * Open a counter of the event loop thread on any CPU, in the group if the
+ * leader is open. If counting the kernel isn't permitted, only user space is
+ * counted. Returns the file descriptor or -1
  */
-local int connectUinput()
+local int openCounter(const profilecounter_t *counter)
 {
-   /*
-    * uinput setup and open a pipe to uinput
-    */
-   struct uinput_setup usetup;
-   int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+   struct perf_event_attr  attr;
+   int                     fd;
 
-   // If unable to open a pipe to uinput...
-   if(fd == -1)
+   memset(&attr, 0, sizeof(attr));
+   attr.size = sizeof(attr);
+   attr.type = counter->type;
+   attr.config = counter->config;
+   attr.read_format = PERF_FORMAT_GROUP;
+   attr.exclude_kernel = profile.userOnly;
+   attr.exclude_hv = 1;
+
+   fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, profile.fd, PERF_FLAG_FD_CLOEXEC);
+   // If not permitted to count the kernel, retry counting user space only
+   if(fd == -1 && (errno == EACCES || errno == EPERM) && !profile.userOnly)
    {
-      exitApp("Unable to open pipe to uinput. Make sure you have permission to access\n\r"
-              "uinput virtual device. Try \"sudo serkey\" to run at root level permissions"
-              , false, -17);
+      profile.userOnly = true;
+      attr.exclude_kernel = 1;
+      fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, profile.fd, PERF_FLAG_FD_CLOEXEC);
    }
+   return(fd);
+}
 
-   /*
-    * The ioctls below will enable the device that is about to be
-    * created. This includes "registering" all the possible key events
-    */
-   ioctl(fd, UI_SET_EVBIT, EV_KEY);
-   for(int i=0;i<256;++i)
+/*
+ * Read the counts of the group with a single system call
+ */
+local void readCounters(uint64_t *values)
+{
+   struct
    {
-      if(keymap[appConfig.keymap][i].key != KEY_RESERVED)
-         ioctl(fd, UI_SET_KEYBIT, keymap[appConfig.keymap][i].key);
+      uint64_t count;
+      uint64_t values[PROFILE_COUNTERS];
+   }group;
 
-      ioctl(fd,UI_SET_KEYBIT,KEY_LEFTSHIFT);
-      ioctl(fd,UI_SET_KEYBIT,KEY_LEFTCTRL);
-   }
+   if(read(profile.fd, &group, sizeof(group)) < (ssize_t)((profile.count + 1) * sizeof(uint64_t)))
+      exitApp("Unable to read the profiling counters", false, -45);
+   memcpy(values, group.values, profile.count * sizeof(uint64_t));
+}
 
-   memset(&usetup, 0, sizeof(usetup));
-   usetup.id.bustype = BUS_USB;
-   usetup.id.vendor = 0x1234; /* sample vendor */
-   usetup.id.product = 0x5678; /* sample product */
-   strncpy(usetup.name, "serkey", sizeof(usetup.name));
+/*
+ * Add the counts since profile.start to the totals, and each count per key
+ * to its distribution. Batches without keys, such as bus framing, only add
+ * to the totals
+ */
+local void endProfile(unsigned long keys)
+{
+   uint64_t values[PROFILE_COUNTERS];
 
-   ioctl(fd, UI_DEV_SETUP, &usetup);
-   ioctl(fd, UI_DEV_CREATE);
+   readCounters(values);
+   ++profile.batches;
+   profile.keys += keys;
 
-   return(fd);
+   // For each counter...
+   for(int i=0;i<profile.count;++i)
+   {
+      uint64_t count = values[i] - profile.start[i];
+
+      // Don't count reading the counters
+      count = (count > profile.overhead[i])?count - profile.overhead[i]:0;
+      profile.total[i] += count;
+
+      // If keys were written, add the count per key to the distribution
+      if(keys)
+      {
+         uint64_t perKey = count / keys;
+         int      bucket = perKey?64 - __builtin_clzll(perKey):0;
+
+         if(bucket >= PROFILE_BUCKETS)
+            bucket = PROFILE_BUCKETS - 1;
+         profile.buckets[i][bucket] += keys;
+         if(perKey > profile.max[i])
+            profile.max[i] = perKey;
+      }
+   }
 }
 
-// Serial Port Functions ******************************************************
 /*
- * Get the current serial configuration
+ * Returns the bucket limit the percentile of the keys' counts is under
  */
-local int getSerialConfig( int fd,                 // File descriptor
-                           struct termios *config) // termios configuration
+local uint64_t profilePercentile(int counter, unsigned percent)
 {
-   int ret = tcgetattr(fd,config);
-   return(ret);
+   uint64_t total = 0, keys = 0;
+   int      i;
+
+   for(i=0;i<PROFILE_BUCKETS;++i)
+      total += profile.buckets[counter][i];
+   for(i=0;i<PROFILE_BUCKETS - 1;++i)
+      if((keys += profile.buckets[counter][i]) * 100 >= total * percent)
+         break;
+   return(1ULL << i);
 }
 
 /*
- * Set the current serial configuration
+ * Display the average count of each counter per key and the distribution
+ * of the counts per key in powers of 2
  */
-local int setSerialConfig( int fd,                 // File descriptor
-                           struct termios *config) // termios configuration
+local void dumpProfile(FILE *output)
 {
-   int ret = tcsetattr(fd,TCSANOW,config);
-   return(ret);
+   fprintf(output, "Profile - keys: %lu batches: %lu counters: %s%s\n\r", profile.keys, profile.batches,
+           profile.software?"software":"hardware", profile.userOnly?" user_only":"");
+
+   // For each counter...
+   for(int i=0;i<profile.count;++i)
+      fprintf(output, "Profile - %s per_key avg: %.1f p50: <%llu p90: <%llu p99: <%llu max: %llu\n\r",
+              profile.counters[i]->name, profile.keys?(double)profile.total[i] / profile.keys:0.0,
+              (unsigned long long)profilePercentile(i, 50), (unsigned long long)profilePercentile(i, 90),
+              (unsigned long long)profilePercentile(i, 99), (unsigned long long)profile.max[i]);
+
+   fflush(output);
 }
 
 /*
- * Setup the serial port
+ * Display the statistics
  */
-local int configSerial( int         fd,         // File descriptor for /dev/tty?
-                        speed_t     speed,      // Baudrate B? [B50 to B115200]
-                        parity_t    parity,     // Parity [PARITY_NONE | PARITY_ODD | PARITY_EVEN]
-                        databits_t  dataBits,   // Number of data bits [DATABITS_5 | DATABITS_6 | DATABITS_7 | DATABITS_8]
-                        stopbits_t  stopBits)   // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+local void dumpStats(FILE *output)
 {
-   struct termios tty;
+   fprintf(output, "Stats - keys: %lu marked: %lu dropped: %lu breaks: %lu feedback_dropped: %lu suppressed: %lu waits: %lu\n\r",
+           stats.keys, stats.marked, stats.dropped, stats.breaks, txQueue.dropped, stats.suppressed, stats.waits);
 
-   // Set the input and output baudrate
-   cfsetospeed(&tty, speed);
-   cfsetispeed(&tty, speed);
+   // If autorepeating...
+   if(appConfig.repeatDelayNs)
+      fprintf(output, "Stats - repeats: %lu\n\r", stats.repeats);
 
-   // Set the data bits
-   tty.c_cflag &= ~CSIZE;
-   tty.c_cflag |= dataBits;
+   // If on a multi-drop bus...
+   if(busDevices)
+      fprintf(output, "Stats - frames: %lu frame_errors: %lu unknown_address: %lu\n\r",
+              stats.frames, stats.frameErrors, stats.unknownAddress);
 
-   // Disable Ignore CR and CR/NL translations
-   tty.c_iflag &= ~(INLCR | IGNCR | ICRNL | ISTRIP); // disable break processing
-   tty.c_lflag = 0;        // no signaling chars, no echo,
-                           // no canonical processing
-   tty.c_oflag = 0;        // no remapping, no delays
+   // If rate limiting or quarantining, display each keypad's counts
+   if(appConfig.rateIntervalNs || appConfig.quarantineBytes)
+   {
+      uint64_t now = monotonicTime();
 
-   // Block until 1 character read
-   tty.c_cc[VMIN]  = 1;
-   tty.c_cc[VTIME] = 0;
+      for(int i=busDevices?1:0;i<=busDevices;++i)
+         fprintf(output, "Stats - keypad: %d keys: %lu limited: %lu unmapped: %lu quarantines: %lu quarantined_bytes: %lu quarantined: %s\n\r",
+                 devices[i].address, devices[i].keys, devices[i].limited, devices[i].unmapped,
+                 devices[i].quarantines, devices[i].quarantined, (now < devices[i].quarantineEnd)?"yes":"no");
+   }
 
-   // Turn off xon/xoff ctrl
-   tty.c_iflag &= ~(IXON | IXOFF | IXANY);
-   // Ignore modem ctrls and enable read
-   tty.c_cflag |= (CLOCAL | CREAD);    
-   // Turn off rts/cts
-   //tty.c_cflag &= ~CRTSCTS;
+   // If the output has stopped accepting events...
+   if(pending.stalls)
+      fprintf(output, "Stats - output_stalls: %lu output_stall_max_us: %llu output_stall_total_us: %llu output_pending_high_water: %zu output_dropped: %lu rts_throttles: %lu\n\r",
+              pending.stalls, (unsigned long long)(pending.stallMax / 1000),
+              (unsigned long long)(pending.stallTotal / 1000),
+              pending.highWater / sizeof(struct input_event), pending.dropped, stats.throttles);
 
-   // Set parity
-   tty.c_cflag &= ~(PARENB | PARODD);
-   if(parity == PARITY_ODD)
-      tty.c_cflag |= (PARENB | PARODD);
-   else if(parity == PARITY_EVEN)
-      tty.c_cflag |= PARENB;
+   // If reading in a separate thread...
+   if(appConfig.threads)
+      fprintf(output, "Stats - queue_high_water: %u queue_size: %d queue_delay_max_us: %llu\n\r",
+              __atomic_load_n(&keyQueue.highWater, __ATOMIC_RELAXED), KEY_QUEUE_SIZE,
+              (unsigned long long)(stats.queueDelayMax / 1000));
 
-   // Set stop bits
-   tty.c_cflag &= ~CSTOPB;
-   tty.c_cflag |= (unsigned int)stopBits;
+   // If the driver error counters are available...
+   if(stats.icountValid)
+      fprintf(output, "Stats - rx: %d overrun: %d buf_overrun: %d parity: %d frame: %d break: %d\n\r",
+              stats.icount.rx, stats.icount.overrun, stats.icount.buf_overrun,
+              stats.icount.parity, stats.icount.frame, stats.icount.brk);
 
-   return(setSerialConfig(fd, &tty));
+   // If profiling...
+   if(profile.fd != -1)
+      dumpProfile(output);
+
+   fflush(output);
 }
 
 /*
- * Open a tty serial device, save it's current config, and set the new config
+ * Display the number of times each keypad sent each byte, the key it maps to
+ * in the keypad's key map, and if it's unmapped, as CSV or JSON. The
+ * keypad is its bus address, or serial if not on a bus. Bytes never
+ * received are skipped
  */
-local int openSerial(char *tty,              // Path/Name of the tty device
-                     speed_t     speed,      // Baudrate B? [B50 to B115200]
-                     parity_t    parity,     // Parity [PARITY_NONE | PARITY_ODD | PARITY_EVEN]
-                     databits_t  dataBits,   // Number of data bits [DATABITS_5 | DATABITS_6 | DATABITS_7 | DATABITS_8]
-                     stopbits_t  stopBits)   // Number of stop bits [STOPBITS_1 | STOPBITS_2]
+local void dumpKeyCounts(FILE *output)
 {
-   int fd;
+   bool first = true;
 
-   // Open the file descriptor
-   if((fd = open(tty, O_RDWR | O_NOCTTY))<0)
-      exitApp("Unable to open to serial device",false,-1);
+   if(appConfig.counts == COUNTS_JSON)
+      fprintf(output, "{\"keypads\":[");
+   else
+      fprintf(output, "keypad,key_map,byte,key,mapped,count\n");
 
-   // Get the current serial device configuration
-   if(getSerialConfig(fd,&ttyConfig))
-      exitApp("Unable to get the current serial device configuration",false,-1);
+   // For each keypad, the serial port's only keypad if not on a bus...
+   for(int d=busDevices?1:0;d<=busDevices;++d)
+   {
+      const device_t *device = &devices[d];
+      const char     *map = deviceKeymapName(device);
+      char           keypad[16];
+      bool           firstCount = true;
 
-   // Setup the new serial device configuration
-   if(configSerial(fd, speed, parity, dataBits, stopBits))
-      exitApp("Unable to set the serial device configuration",false,-1);
+      if(busDevices)
+         snprintf(keypad, sizeof(keypad), "%d", device->address);
+      else
+         strcpy(keypad, "serial");
 
-   return(fd);
-}
+      if(appConfig.counts == COUNTS_JSON)
+         fprintf(output, "%s{\"keypad\":\"%s\",\"key_map\":\"%s\",\"counts\":[", first?"":",", keypad, map);
+      first = false;
 
-/*
- * Close a tty serial device and restore it's config
- */
-local int closeSerial(int fd)    // File descriptor of serial device
-{
-   if(setSerialConfig(ttyFd,&ttyConfig))
-      exitApp("Unable to reset the serial device configuration",false,-1);
-   return(close(fd));
+      // For each byte received...
+      for(int i=0;i<KEYS_PER_MAP;++i)
+      {
+         uint64_t count = __atomic_load_n(&device->keyCounts[i], __ATOMIC_RELAXED);
+         int      key = device->map[i].key;
+
+         if(count == 0)
+            continue;
+
+         if(appConfig.counts == COUNTS_JSON)
+            fprintf(output, "%s{\"byte\":%d,\"key\":%d,\"mapped\":%s,\"count\":%llu}",
+                    firstCount?"":",", i, key, (key != KEY_RESERVED)?"true":"false", (unsigned long long)count);
+         else
+            fprintf(output, "%s,%s,%d,%d,%d,%llu\n", keypad, map, i, key, key != KEY_RESERVED, (unsigned long long)count);
+         firstCount = false;
+      }
+
+      if(appConfig.counts == COUNTS_JSON)
+         fprintf(output, "]}");
+   }
+
+   if(appConfig.counts == COUNTS_JSON)
+      fprintf(output, "]}\n");
+
+   fflush(output);
 }
 
 // Key Maps *******************************************************************
@@ -920,777 +6071,777 @@ local keymap_t keymap[KEYMAPS][KEYS_PER_MAP] =
         { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true }    // 255	nbsp	(non-breaking space or no-break space)
     },
     { // ASCII Keymap -----------------------------------------------------------------------------------------------------------------------------------------
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 0	NULL(Null character)			
-        { .key = KEY_A, .control = true, .shift = false, .makebreak = false },           // 1	SOH	(Start of Header)
-        { .key = KEY_B, .control = true, .shift = false, .makebreak = false },           // 2	STX	(Start of Text)			
-        { .key = KEY_C, .control = true, .shift = false, .makebreak = false },           // 3	ETX	(End of Text)			
-        { .key = KEY_D, .control = true, .shift = false, .makebreak = false },           // 4	EOT	(End of Transmission)			
-        { .key = KEY_E, .control = true, .shift = false, .makebreak = false },           // 5	ENQ	(Enquiry)			
-        { .key = KEY_F, .control = true, .shift = false, .makebreak = false },           // 6	ACK	(Acknowledgement)			
-        { .key = KEY_G, .control = true, .shift = false, .makebreak = false },           // 7	BEL	(Bell)			
-        { .key = KEY_H, .control = true, .shift = false, .makebreak = false },           // 8	BS	(Backspace)			
-        { .key = KEY_I, .control = true, .shift = false, .makebreak = false },           // 9	HT	(Horizontal Tab)			
-        { .key = KEY_J, .control = true, .shift = false, .makebreak = false },           // 10	LF	(Line feed)			
-        { .key = KEY_K, .control = true, .shift = false, .makebreak = false },           // 11	VT	(Vertical Tab)			
-        { .key = KEY_L, .control = true, .shift = false, .makebreak = false },           // 12	FF	(Form feed)			
-        { .key = KEY_M, .control = true, .shift = false, .makebreak = false },           // 13	CR	(Carriage return)			
-        { .key = KEY_N, .control = true, .shift = false, .makebreak = false },           // 14	SO	(Shift Out)			
-        { .key = KEY_O, .control = true, .shift = false, .makebreak = false },           // 15	SI	(Shift In)			
-        { .key = KEY_P, .control = true, .shift = false, .makebreak = false },           // 16	DLE	(Data link escape)			
-        { .key = KEY_Q, .control = true, .shift = false, .makebreak = false },           // 17	DC1	(Device control 1)			
-        { .key = KEY_R, .control = true, .shift = false, .makebreak = false },           // 18	DC2	(Device control 2)			
-        { .key = KEY_S, .control = true, .shift = false, .makebreak = false },           // 19	DC3	(Device control 3)			
-        { .key = KEY_T, .control = true, .shift = false, .makebreak = false },           // 20	DC4	(Device control 4)			
-        { .key = KEY_U, .control = true, .shift = false, .makebreak = false },           // 21	NAK	(Negative acknowledgement)			
-        { .key = KEY_V, .control = true, .shift = false, .makebreak = false },           // 22	SYN	(Synchronous idle)			
-        { .key = KEY_W, .control = true, .shift = false, .makebreak = false },           // 23	ETB	(End of transmission block)			
-        { .key = KEY_X, .control = true, .shift = false, .makebreak = false },           // 24	CAN	(Cancel)			
-        { .key = KEY_Y, .control = true, .shift = false, .makebreak = false },           // 25	EM	(End of medium)			
-        { .key = KEY_Z, .control = true, .shift = false, .makebreak = false },           // 26	SUB	(Substitute)			
-        { .key = KEY_LEFTBRACE, .control = true, .shift = false, .makebreak = false },   // 27	ESC	(Escape)			
-        { .key = KEY_BACKSLASH, .control = true, .shift = false, .makebreak = false },   // 28	FS	(File separator)			
-        { .key = KEY_RIGHTBRACE, .control = true, .shift = false, .makebreak = false },  // 29	GS	(Group separator)			
-        { .key = KEY_6, .control = true, .shift = true, .makebreak = false },            // 30	RS	(Record separator)			
-        { .key = KEY_MINUS, .control = true, .shift = true, .makebreak = false },        // 31	US	(Unit separator)			
-        { .key = KEY_SPACE, .control = false, .shift = false, .makebreak = false },      // 32	 	(space)			
-        { .key = KEY_1, .control = false, .shift = true, .makebreak = false },           // 33	!	(exclamation mark)			
-        { .key = KEY_APOSTROPHE, .control = false, .shift = true, .makebreak = false },  // 34	"	(Quotation mark)			
-        { .key = KEY_3, .control = false, .shift = true, .makebreak = false },           // 35	#	(Number sign)			
-        { .key = KEY_4, .control = false, .shift = true, .makebreak = false },           // 36	$	(Dollar sign)			
-        { .key = KEY_5, .control = false, .shift = true, .makebreak = false },           // 37	%	(Percent sign)			
-        { .key = KEY_7, .control = false, .shift = true, .makebreak = false },           // 38	&	(Ampersand)			
-        { .key = KEY_APOSTROPHE, .control = false, .shift = false, .makebreak = false }, // 39	'	(Apostrophe)			
-        { .key = KEY_9, .control = false, .shift = true, .makebreak = false },           // 40	(	(round brackets or parentheses)			
-        { .key = KEY_0, .control = false, .shift = true, .makebreak = false },           // 41	)	(round brackets or parentheses)			
-        { .key = KEY_8, .control = false, .shift = true, .makebreak = false },           // 42	*	(Asterisk)			
-        { .key = KEY_EQUAL, .control = false, .shift = true, .makebreak = false },       // 43	+	(Plus sign)			
-        { .key = KEY_COMMA, .control = false, .shift = false, .makebreak = false },      // 44	,	(Comma)			
-        { .key = KEY_MINUS, .control = false, .shift = true, .makebreak = false },       // 45	-	(Hyphen)			
-        { .key = KEY_DOT, .control = false, .shift = false, .makebreak = false },        // 46	.	(Full stop , dot)			
-        { .key = KEY_SLASH, .control = false, .shift = false, .makebreak = false },      // 47	/	(Slash)			
-        { .key = KEY_0, .control = false, .shift = false, .makebreak = false },          // 48	0	(number zero)			
-        { .key = KEY_1, .control = false, .shift = false, .makebreak = false },          // 49	1	(number one)			
-        { .key = KEY_2, .control = false, .shift = false, .makebreak = false },          // 50	2	(number two)			
-        { .key = KEY_3, .control = false, .shift = false, .makebreak = false },          // 51	3	(number three)			
-        { .key = KEY_4, .control = false, .shift = false, .makebreak = false },          // 52	4	(number four)			
-        { .key = KEY_5, .control = false, .shift = false, .makebreak = false },          // 53	5	(number five)			
-        { .key = KEY_6, .control = false, .shift = false, .makebreak = false },          // 54	6	(number six)			
-        { .key = KEY_7, .control = false, .shift = false, .makebreak = false },          // 55	7	(number seven)			
-        { .key = KEY_8, .control = false, .shift = false, .makebreak = false },          // 56	8	(number eight)			
-        { .key = KEY_9, .control = false, .shift = false, .makebreak = false },          // 57	9	(number nine)			
-        { .key = KEY_SEMICOLON, .control = false, .shift = true, .makebreak = false },   // 58	:	(Colon)			
-        { .key = KEY_SEMICOLON, .control = false, .shift = false, .makebreak = false },  // 59	;	(Semicolon)			
-        { .key = KEY_COMMA, .control = false, .shift = true, .makebreak = false },       // 60	<	(Less-than sign )			
-        { .key = KEY_EQUAL, .control = false, .shift = false, .makebreak = false },      // 61	=	(Equals sign)			
-        { .key = KEY_DOT, .control = false, .shift = true, .makebreak = false },         // 62	>	(Greater-than sign ; Inequality) 			
-        { .key = KEY_SLASH, .control = false, .shift = true, .makebreak = false },       // 63	?	(Question mark)			
-        { .key = KEY_2, .control = false, .shift = true, .makebreak = false },           // 64	@	(At sign)			
-        { .key = KEY_A, .control = false, .shift = true, .makebreak = false },           // 65	A	(Capital A )			
-        { .key = KEY_B, .control = false, .shift = true, .makebreak = false },           // 66	B	(Capital B )			
-        { .key = KEY_C, .control = false, .shift = true, .makebreak = false },           // 67	C	(Capital C )			
-        { .key = KEY_D, .control = false, .shift = true, .makebreak = false },           // 68	D	(Capital D )			
-        { .key = KEY_E, .control = false, .shift = true, .makebreak = false },           // 69	E	(Capital E )			
-        { .key = KEY_F, .control = false, .shift = true, .makebreak = false },           // 70	F	(Capital F )			
-        { .key = KEY_G, .control = false, .shift = true, .makebreak = false },           // 71	G	(Capital G )			
-        { .key = KEY_H, .control = false, .shift = true, .makebreak = false },           // 72	H	(Capital H )			
-        { .key = KEY_I, .control = false, .shift = true, .makebreak = false },           // 73	I	(Capital I )			
-        { .key = KEY_J, .control = false, .shift = true, .makebreak = false },           // 74	J	(Capital J )			
-        { .key = KEY_K, .control = false, .shift = true, .makebreak = false },           // 75	K	(Capital K )			
-        { .key = KEY_L, .control = false, .shift = true, .makebreak = false },           // 76	L	(Capital L )			
-        { .key = KEY_M, .control = false, .shift = true, .makebreak = false },           // 77	M	(Capital M )			
-        { .key = KEY_N, .control = false, .shift = true, .makebreak = false },           // 78	N	(Capital N )			
-        { .key = KEY_O, .control = false, .shift = true, .makebreak = false },           // 79	O	(Capital O )			
-        { .key = KEY_P, .control = false, .shift = true, .makebreak = false },           // 80	P	(Capital P )			
-        { .key = KEY_Q, .control = false, .shift = true, .makebreak = false },           // 81	Q	(Capital Q )			
-        { .key = KEY_R, .control = false, .shift = true, .makebreak = false },           // 82	R	(Capital R )			
-        { .key = KEY_S, .control = false, .shift = true, .makebreak = false },           // 83	S	(Capital S )			
-        { .key = KEY_T, .control = false, .shift = true, .makebreak = false },           // 84	T	(Capital T )			
-        { .key = KEY_U, .control = false, .shift = true, .makebreak = false },           // 85	U	(Capital U )			
-        { .key = KEY_V, .control = false, .shift = true, .makebreak = false },           // 86	V	(Capital V )			
-        { .key = KEY_W, .control = false, .shift = true, .makebreak = false },           // 87	W	(Capital W )			
-        { .key = KEY_X, .control = false, .shift = true, .makebreak = false },           // 88	X	(Capital X )			
-        { .key = KEY_Y, .control = false, .shift = true, .makebreak = false },           // 89	Y	(Capital Y )			
-        { .key = KEY_Z, .control = false, .shift = true, .makebreak = false },           // 90	Z	(Capital Z )			
-        { .key = KEY_LEFTBRACE, .control = false, .shift = false, .makebreak = false },  // 91	[	(square brackets or box brackets)			
-        { .key = KEY_BACKSLASH, .control = false, .shift = false, .makebreak = false },  // 92	\	(Backslash)			
-        { .key = KEY_RIGHTBRACE, .control = false, .shift = false, .makebreak = false }, // 93	]	(square brackets or box brackets)			
-        { .key = KEY_6, .control = false, .shift = true, .makebreak = false },           // 94	^	(Caret or circumflex accent)			
-        { .key = KEY_MINUS, .control = false, .shift = true, .makebreak = false },       // 95	_	(underscore , understrike , underbar or low line)			
-        { .key = KEY_GRAVE, .control = false, .shift = false, .makebreak = false },      // 96	`	(Grave accent)			
-        { .key = KEY_A, .control = false, .shift = false, .makebreak = false },          // 97	a	(Lowercase  a )			
-        { .key = KEY_B, .control = false, .shift = false, .makebreak = false },          // 98	b	(Lowercase  b )			
-        { .key = KEY_C, .control = false, .shift = false, .makebreak = false },          // 99	c	(Lowercase  c )			
-        { .key = KEY_D, .control = false, .shift = false, .makebreak = false },          // 100	d	(Lowercase  d )			
-        { .key = KEY_E, .control = false, .shift = false, .makebreak = false },          // 101	e	(Lowercase  e )			
-        { .key = KEY_F, .control = false, .shift = false, .makebreak = false },          // 102	f	(Lowercase  f )			
-        { .key = KEY_G, .control = false, .shift = false, .makebreak = false },          // 103	g	(Lowercase  g )			
-        { .key = KEY_H, .control = false, .shift = false, .makebreak = false },          // 104	h	(Lowercase  h )			
-        { .key = KEY_I, .control = false, .shift = false, .makebreak = false },          // 105	i	(Lowercase  i )			
-        { .key = KEY_J, .control = false, .shift = false, .makebreak = false },          // 106	j	(Lowercase  j )			
-        { .key = KEY_K, .control = false, .shift = false, .makebreak = false },          // 107	k	(Lowercase  k )			
-        { .key = KEY_L, .control = false, .shift = false, .makebreak = false },          // 108	l	(Lowercase  l )			
-        { .key = KEY_M, .control = false, .shift = false, .makebreak = false },          // 109	m	(Lowercase  m )			
-        { .key = KEY_N, .control = false, .shift = false, .makebreak = false },          // 110	n	(Lowercase  n )			
-        { .key = KEY_O, .control = false, .shift = false, .makebreak = false },          // 111	o	(Lowercase  o )			
-        { .key = KEY_P, .control = false, .shift = false, .makebreak = false },          // 112	p	(Lowercase  p )			
-        { .key = KEY_Q, .control = false, .shift = false, .makebreak = false },          // 113	q	(Lowercase  q )			
-        { .key = KEY_R, .control = false, .shift = false, .makebreak = false },          // 114	r	(Lowercase  r )			
-        { .key = KEY_S, .control = false, .shift = false, .makebreak = false },          // 115	s	(Lowercase  s )			
-        { .key = KEY_T, .control = false, .shift = false, .makebreak = false },          // 116	t	(Lowercase  t )			
-        { .key = KEY_U, .control = false, .shift = false, .makebreak = false },          // 117	u	(Lowercase  u )			
-        { .key = KEY_V, .control = false, .shift = false, .makebreak = false },          // 118	v	(Lowercase  v )			
-        { .key = KEY_W, .control = false, .shift = false, .makebreak = false },          // 119	w	(Lowercase  w )			
-        { .key = KEY_X, .control = false, .shift = false, .makebreak = false },          // 120	x	(Lowercase  x )			
-        { .key = KEY_Y, .control = false, .shift = false, .makebreak = false },          // 121	y	(Lowercase  y )			
-        { .key = KEY_Z, .control = false, .shift = false, .makebreak = false },          // 122	z	(Lowercase  z )			
-        { .key = KEY_LEFTBRACE, .control = false, .shift = true, .makebreak = false },   // 123	{	(curly brackets or braces)			
-        { .key = KEY_BACKSLASH, .control = false, .shift = false, .makebreak = false },  // 124	|	(vertical-bar, vbar, vertical line or vertical slash)			
-        { .key = KEY_RIGHTBRACE, .control = false, .shift = true, .makebreak = false },  // 125	}	(curly brackets or braces)			
-        { .key = KEY_GRAVE, .control = false, .shift = true, .makebreak = false },       // 126	~	(Tilde ; swung dash)			
-        { .key = KEY_DELETE, .control = false, .shift = false, .makebreak = false },     // 127	DEL	(Delete)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 128	Ç	(Majuscule C-cedilla )			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 129	ü	(letter "u" with umlaut or diaeresis ; "u-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 130	é	(letter "e" with acute accent or "e-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 131	â	(letter "a" with circumflex accent or "a-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 132	ä	(letter "a" with umlaut or diaeresis ; "a-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 133	à	(letter "a" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 134	å	(letter "a"  with a ring)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 135	ç	(Minuscule c-cedilla)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 136	ê	(letter "e" with circumflex accent or "e-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 137	ë	(letter "e" with umlaut or diaeresis ; "e-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 138	è	(letter "e" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 139	ï	(letter "i" with umlaut or diaeresis ; "i-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 140	î	(letter "i" with circumflex accent or "i-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 141	ì	(letter "i" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 142	Ä	(letter "A" with umlaut or diaeresis ; "A-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 143	Å	(letter "A"  with a ring)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 144	É	(Capital letter "E" with acute accent or "E-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 145	æ	(Latin diphthong "ae")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 146	Æ	(Latin diphthong "AE")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 147	ô	(letter "o" with circumflex accent or "o-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 148	ö	(letter "o" with umlaut or diaeresis ; "o-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 149	ò	(letter "o" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 150	û	(letter "u" with circumflex accent or "u-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 151	ù	(letter "u" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 152	ÿ	(letter "y" with diaeresis)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 153	Ö	(letter "O" with umlaut or diaeresis ; "O-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 154	Ü	(letter "U" with umlaut or diaeresis ; "U-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 155	ø	(slashed zero or empty set)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 156	£	(Pound sign ; symbol for the pound sterling)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 157	Ø	(slashed zero or empty set)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 158	×	(multiplication sign)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 159	ƒ	(function sign ; f with hook sign ; florin sign )			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 160	á	(letter "a" with acute accent or "a-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 161	í	(letter "i" with acute accent or "i-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 162	ó	(letter "o" with acute accent or "o-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 163	ú	(letter "u" with acute accent or "u-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 164	ñ	(letter "n" with tilde ; enye)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 165	Ñ	(letter "N" with tilde ; enye)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 166	ª	(feminine ordinal indicator )			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 167	º	(masculine ordinal indicator)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 168	¿	(Inverted question marks)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 169	®	(Registered trademark symbol)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 170	¬	(Logical negation symbol)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 171	½	(One half)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 172	¼	(Quarter or  one fourth)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 173	¡	(Inverted exclamation marks)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 174	«	(Guillemets or  angle quotes)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 175	»	(Guillemets or  angle quotes)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 176	░				
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 177	▒				
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 178	▓				
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 179	│	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 180	┤	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 181	Á	(Capital letter "A" with acute accent or "A-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 182	Â	(letter "A" with circumflex accent or "A-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 183	À	(letter "A" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 184	©	(Copyright symbol)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 185	╣	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 186	║	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 187	╗	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 188	╝	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 189	¢	(Cent symbol)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 190	¥	(YEN and YUAN sign)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 191	┐	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 192	└	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 193	┴	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 194	┬	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 195	├	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 196	─	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 197	┼	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 198	ã	(letter "a" with tilde or "a-tilde")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 199	Ã	(letter "A" with tilde or "A-tilde")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 200	╚	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 201	╔	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 202	╩	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 203	╦	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 204	╠	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 205	═	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 206	╬	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 207	¤	(generic currency sign )			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 208	ð	(lowercase "eth")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 209	Ð	(Capital letter "Eth")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 210	Ê	(letter "E" with circumflex accent or "E-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 211	Ë	(letter "E" with umlaut or diaeresis ; "E-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 212	È	(letter "E" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 213	ı	(lowercase dot less i)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 214	Í	(Capital letter "I" with acute accent or "I-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 215	Î	(letter "I" with circumflex accent or "I-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 216	Ï	(letter "I" with umlaut or diaeresis ; "I-umlaut")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 217	┘	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 218	┌	(Box drawing character)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 219	█	(Block)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 220	▄				
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 221	¦	(vertical broken bar )			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 222	Ì	(letter "I" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 223	▀				
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 224	Ó	(Capital letter "O" with acute accent or "O-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 225	ß	(letter "Eszett" ; "scharfes S" or "sharp S")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 226	Ô	(letter "O" with circumflex accent or "O-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 227	Ò	(letter "O" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 228	õ	(letter "o" with tilde or "o-tilde")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 229	Õ	(letter "O" with tilde or "O-tilde")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 230	µ	(Lowercase letter "Mu" ; micro sign or micron)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 231	þ	(capital letter "Thorn")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 232	Þ	(lowercase letter "thorn")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 233	Ú	(Capital letter "U" with acute accent or "U-acute")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 234	Û	(letter "U" with circumflex accent or "U-circumflex")			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 235	Ù	(letter "U" with grave accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 236	ý	(letter "y" with acute accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 237	Ý	(Capital letter "Y" with acute accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 238	¯	(macron symbol)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 239	´	(Acute accent)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 240	¬	(Hyphen)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 241	±	(Plus-minus sign)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 242	‗	(underline or underscore)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 243	¾	(three quarters)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 244	¶	(paragraph sign or pilcrow)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 245	§	(Section sign)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 246	÷	(The division sign ; Obelus)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 247	¸	(cedilla)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 248	°	(degree symbol )			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 249	¨	(Diaeresis)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 250	•	(Interpunct or space dot)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 251	¹	(superscript one)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 252	³	(cube or superscript three)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 253	²	(Square or superscript two)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },   // 254	■	(black square)			
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false }    // 255	nbsp	(non-breaking space or no-break space)
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 0	NULL(Null character)			
+        { .key = KEY_A, .control = true, .shift = false, .makebreak = true },            // 1	SOH	(Start of Header)
+        { .key = KEY_B, .control = true, .shift = false, .makebreak = true },            // 2	STX	(Start of Text)			
+        { .key = KEY_C, .control = true, .shift = false, .makebreak = true },            // 3	ETX	(End of Text)			
+        { .key = KEY_D, .control = true, .shift = false, .makebreak = true },            // 4	EOT	(End of Transmission)			
+        { .key = KEY_E, .control = true, .shift = false, .makebreak = true },            // 5	ENQ	(Enquiry)			
+        { .key = KEY_F, .control = true, .shift = false, .makebreak = true },            // 6	ACK	(Acknowledgement)			
+        { .key = KEY_G, .control = true, .shift = false, .makebreak = true },            // 7	BEL	(Bell)			
+        { .key = KEY_H, .control = true, .shift = false, .makebreak = true },            // 8	BS	(Backspace)			
+        { .key = KEY_I, .control = true, .shift = false, .makebreak = true },            // 9	HT	(Horizontal Tab)			
+        { .key = KEY_J, .control = true, .shift = false, .makebreak = true },            // 10	LF	(Line feed)			
+        { .key = KEY_K, .control = true, .shift = false, .makebreak = true },            // 11	VT	(Vertical Tab)			
+        { .key = KEY_L, .control = true, .shift = false, .makebreak = true },            // 12	FF	(Form feed)			
+        { .key = KEY_M, .control = true, .shift = false, .makebreak = true },            // 13	CR	(Carriage return)			
+        { .key = KEY_N, .control = true, .shift = false, .makebreak = true },            // 14	SO	(Shift Out)			
+        { .key = KEY_O, .control = true, .shift = false, .makebreak = true },            // 15	SI	(Shift In)			
+        { .key = KEY_P, .control = true, .shift = false, .makebreak = true },            // 16	DLE	(Data link escape)			
+        { .key = KEY_Q, .control = true, .shift = false, .makebreak = true },            // 17	DC1	(Device control 1)			
+        { .key = KEY_R, .control = true, .shift = false, .makebreak = true },            // 18	DC2	(Device control 2)			
+        { .key = KEY_S, .control = true, .shift = false, .makebreak = true },            // 19	DC3	(Device control 3)			
+        { .key = KEY_T, .control = true, .shift = false, .makebreak = true },            // 20	DC4	(Device control 4)			
+        { .key = KEY_U, .control = true, .shift = false, .makebreak = true },            // 21	NAK	(Negative acknowledgement)			
+        { .key = KEY_V, .control = true, .shift = false, .makebreak = true },            // 22	SYN	(Synchronous idle)			
+        { .key = KEY_W, .control = true, .shift = false, .makebreak = true },            // 23	ETB	(End of transmission block)			
+        { .key = KEY_X, .control = true, .shift = false, .makebreak = true },            // 24	CAN	(Cancel)			
+        { .key = KEY_Y, .control = true, .shift = false, .makebreak = true },            // 25	EM	(End of medium)			
+        { .key = KEY_Z, .control = true, .shift = false, .makebreak = true },            // 26	SUB	(Substitute)			
+        { .key = KEY_LEFTBRACE, .control = true, .shift = false, .makebreak = true },    // 27	ESC	(Escape)			
+        { .key = KEY_BACKSLASH, .control = true, .shift = false, .makebreak = true },    // 28	FS	(File separator)			
+        { .key = KEY_RIGHTBRACE, .control = true, .shift = false, .makebreak = true },   // 29	GS	(Group separator)			
+        { .key = KEY_6, .control = true, .shift = true, .makebreak = true },             // 30	RS	(Record separator)			
+        { .key = KEY_MINUS, .control = true, .shift = true, .makebreak = true },         // 31	US	(Unit separator)			
+        { .key = KEY_SPACE, .control = false, .shift = false, .makebreak = true },       // 32	 	(space)			
+        { .key = KEY_1, .control = false, .shift = true, .makebreak = true },            // 33	!	(exclamation mark)			
+        { .key = KEY_APOSTROPHE, .control = false, .shift = true, .makebreak = true },   // 34	"	(Quotation mark)			
+        { .key = KEY_3, .control = false, .shift = true, .makebreak = true },            // 35	#	(Number sign)			
+        { .key = KEY_4, .control = false, .shift = true, .makebreak = true },            // 36	$	(Dollar sign)			
+        { .key = KEY_5, .control = false, .shift = true, .makebreak = true },            // 37	%	(Percent sign)			
+        { .key = KEY_7, .control = false, .shift = true, .makebreak = true },            // 38	&	(Ampersand)			
+        { .key = KEY_APOSTROPHE, .control = false, .shift = false, .makebreak = true },  // 39	'	(Apostrophe)			
+        { .key = KEY_9, .control = false, .shift = true, .makebreak = true },            // 40	(	(round brackets or parentheses)			
+        { .key = KEY_0, .control = false, .shift = true, .makebreak = true },            // 41	)	(round brackets or parentheses)			
+        { .key = KEY_8, .control = false, .shift = true, .makebreak = true },            // 42	*	(Asterisk)			
+        { .key = KEY_EQUAL, .control = false, .shift = true, .makebreak = true },        // 43	+	(Plus sign)			
+        { .key = KEY_COMMA, .control = false, .shift = false, .makebreak = true },       // 44	,	(Comma)			
+        { .key = KEY_MINUS, .control = false, .shift = true, .makebreak = true },        // 45	-	(Hyphen)			
+        { .key = KEY_DOT, .control = false, .shift = false, .makebreak = true },         // 46	.	(Full stop , dot)			
+        { .key = KEY_SLASH, .control = false, .shift = false, .makebreak = true },       // 47	/	(Slash)			
+        { .key = KEY_0, .control = false, .shift = false, .makebreak = true },           // 48	0	(number zero)			
+        { .key = KEY_1, .control = false, .shift = false, .makebreak = true },           // 49	1	(number one)			
+        { .key = KEY_2, .control = false, .shift = false, .makebreak = true },           // 50	2	(number two)			
+        { .key = KEY_3, .control = false, .shift = false, .makebreak = true },           // 51	3	(number three)			
+        { .key = KEY_4, .control = false, .shift = false, .makebreak = true },           // 52	4	(number four)			
+        { .key = KEY_5, .control = false, .shift = false, .makebreak = true },           // 53	5	(number five)			
+        { .key = KEY_6, .control = false, .shift = false, .makebreak = true },           // 54	6	(number six)			
+        { .key = KEY_7, .control = false, .shift = false, .makebreak = true },           // 55	7	(number seven)			
+        { .key = KEY_8, .control = false, .shift = false, .makebreak = true },           // 56	8	(number eight)			
+        { .key = KEY_9, .control = false, .shift = false, .makebreak = true },           // 57	9	(number nine)			
+        { .key = KEY_SEMICOLON, .control = false, .shift = true, .makebreak = true },    // 58	:	(Colon)			
+        { .key = KEY_SEMICOLON, .control = false, .shift = false, .makebreak = true },   // 59	;	(Semicolon)			
+        { .key = KEY_COMMA, .control = false, .shift = true, .makebreak = true },        // 60	<	(Less-than sign )			
+        { .key = KEY_EQUAL, .control = false, .shift = false, .makebreak = true },       // 61	=	(Equals sign)			
+        { .key = KEY_DOT, .control = false, .shift = true, .makebreak = true },          // 62	>	(Greater-than sign ; Inequality) 			
+        { .key = KEY_SLASH, .control = false, .shift = true, .makebreak = true },        // 63	?	(Question mark)			
+        { .key = KEY_2, .control = false, .shift = true, .makebreak = true },            // 64	@	(At sign)			
+        { .key = KEY_A, .control = false, .shift = true, .makebreak = true },            // 65	A	(Capital A )			
+        { .key = KEY_B, .control = false, .shift = true, .makebreak = true },            // 66	B	(Capital B )			
+        { .key = KEY_C, .control = false, .shift = true, .makebreak = true },            // 67	C	(Capital C )			
+        { .key = KEY_D, .control = false, .shift = true, .makebreak = true },            // 68	D	(Capital D )			
+        { .key = KEY_E, .control = false, .shift = true, .makebreak = true },            // 69	E	(Capital E )			
+        { .key = KEY_F, .control = false, .shift = true, .makebreak = true },            // 70	F	(Capital F )			
+        { .key = KEY_G, .control = false, .shift = true, .makebreak = true },            // 71	G	(Capital G )			
+        { .key = KEY_H, .control = false, .shift = true, .makebreak = true },            // 72	H	(Capital H )			
+        { .key = KEY_I, .control = false, .shift = true, .makebreak = true },            // 73	I	(Capital I )			
+        { .key = KEY_J, .control = false, .shift = true, .makebreak = true },            // 74	J	(Capital J )			
+        { .key = KEY_K, .control = false, .shift = true, .makebreak = true },            // 75	K	(Capital K )			
+        { .key = KEY_L, .control = false, .shift = true, .makebreak = true },            // 76	L	(Capital L )			
+        { .key = KEY_M, .control = false, .shift = true, .makebreak = true },            // 77	M	(Capital M )			
+        { .key = KEY_N, .control = false, .shift = true, .makebreak = true },            // 78	N	(Capital N )			
+        { .key = KEY_O, .control = false, .shift = true, .makebreak = true },            // 79	O	(Capital O )			
+        { .key = KEY_P, .control = false, .shift = true, .makebreak = true },            // 80	P	(Capital P )			
+        { .key = KEY_Q, .control = false, .shift = true, .makebreak = true },            // 81	Q	(Capital Q )			
+        { .key = KEY_R, .control = false, .shift = true, .makebreak = true },            // 82	R	(Capital R )			
+        { .key = KEY_S, .control = false, .shift = true, .makebreak = true },            // 83	S	(Capital S )			
+        { .key = KEY_T, .control = false, .shift = true, .makebreak = true },            // 84	T	(Capital T )			
+        { .key = KEY_U, .control = false, .shift = true, .makebreak = true },            // 85	U	(Capital U )			
+        { .key = KEY_V, .control = false, .shift = true, .makebreak = true },            // 86	V	(Capital V )			
+        { .key = KEY_W, .control = false, .shift = true, .makebreak = true },            // 87	W	(Capital W )			
+        { .key = KEY_X, .control = false, .shift = true, .makebreak = true },            // 88	X	(Capital X )			
+        { .key = KEY_Y, .control = false, .shift = true, .makebreak = true },            // 89	Y	(Capital Y )			
+        { .key = KEY_Z, .control = false, .shift = true, .makebreak = true },            // 90	Z	(Capital Z )			
+        { .key = KEY_LEFTBRACE, .control = false, .shift = false, .makebreak = true },   // 91	[	(square brackets or box brackets)			
+        { .key = KEY_BACKSLASH, .control = false, .shift = false, .makebreak = true },   // 92	\	(Backslash)			
+        { .key = KEY_RIGHTBRACE, .control = false, .shift = false, .makebreak = true },  // 93	]	(square brackets or box brackets)			
+        { .key = KEY_6, .control = false, .shift = true, .makebreak = true },            // 94	^	(Caret or circumflex accent)			
+        { .key = KEY_MINUS, .control = false, .shift = true, .makebreak = true },        // 95	_	(underscore , understrike , underbar or low line)			
+        { .key = KEY_GRAVE, .control = false, .shift = false, .makebreak = true },       // 96	`	(Grave accent)			
+        { .key = KEY_A, .control = false, .shift = false, .makebreak = true },           // 97	a	(Lowercase  a )			
+        { .key = KEY_B, .control = false, .shift = false, .makebreak = true },           // 98	b	(Lowercase  b )			
+        { .key = KEY_C, .control = false, .shift = false, .makebreak = true },           // 99	c	(Lowercase  c )			
+        { .key = KEY_D, .control = false, .shift = false, .makebreak = true },           // 100	d	(Lowercase  d )			
+        { .key = KEY_E, .control = false, .shift = false, .makebreak = true },           // 101	e	(Lowercase  e )			
+        { .key = KEY_F, .control = false, .shift = false, .makebreak = true },           // 102	f	(Lowercase  f )			
+        { .key = KEY_G, .control = false, .shift = false, .makebreak = true },           // 103	g	(Lowercase  g )			
+        { .key = KEY_H, .control = false, .shift = false, .makebreak = true },           // 104	h	(Lowercase  h )			
+        { .key = KEY_I, .control = false, .shift = false, .makebreak = true },           // 105	i	(Lowercase  i )			
+        { .key = KEY_J, .control = false, .shift = false, .makebreak = true },           // 106	j	(Lowercase  j )			
+        { .key = KEY_K, .control = false, .shift = false, .makebreak = true },           // 107	k	(Lowercase  k )			
+        { .key = KEY_L, .control = false, .shift = false, .makebreak = true },           // 108	l	(Lowercase  l )			
+        { .key = KEY_M, .control = false, .shift = false, .makebreak = true },           // 109	m	(Lowercase  m )			
+        { .key = KEY_N, .control = false, .shift = false, .makebreak = true },           // 110	n	(Lowercase  n )			
+        { .key = KEY_O, .control = false, .shift = false, .makebreak = true },           // 111	o	(Lowercase  o )			
+        { .key = KEY_P, .control = false, .shift = false, .makebreak = true },           // 112	p	(Lowercase  p )			
+        { .key = KEY_Q, .control = false, .shift = false, .makebreak = true },           // 113	q	(Lowercase  q )			
+        { .key = KEY_R, .control = false, .shift = false, .makebreak = true },           // 114	r	(Lowercase  r )			
+        { .key = KEY_S, .control = false, .shift = false, .makebreak = true },           // 115	s	(Lowercase  s )			
+        { .key = KEY_T, .control = false, .shift = false, .makebreak = true },           // 116	t	(Lowercase  t )			
+        { .key = KEY_U, .control = false, .shift = false, .makebreak = true },           // 117	u	(Lowercase  u )			
+        { .key = KEY_V, .control = false, .shift = false, .makebreak = true },           // 118	v	(Lowercase  v )			
+        { .key = KEY_W, .control = false, .shift = false, .makebreak = true },           // 119	w	(Lowercase  w )			
+        { .key = KEY_X, .control = false, .shift = false, .makebreak = true },           // 120	x	(Lowercase  x )			
+        { .key = KEY_Y, .control = false, .shift = false, .makebreak = true },           // 121	y	(Lowercase  y )			
+        { .key = KEY_Z, .control = false, .shift = false, .makebreak = true },           // 122	z	(Lowercase  z )			
+        { .key = KEY_LEFTBRACE, .control = false, .shift = true, .makebreak = true },    // 123	{	(curly brackets or braces)			
+        { .key = KEY_BACKSLASH, .control = false, .shift = false, .makebreak = true },   // 124	|	(vertical-bar, vbar, vertical line or vertical slash)			
+        { .key = KEY_RIGHTBRACE, .control = false, .shift = true, .makebreak = true },   // 125	}	(curly brackets or braces)			
+        { .key = KEY_GRAVE, .control = false, .shift = true, .makebreak = true },        // 126	~	(Tilde ; swung dash)			
+        { .key = KEY_DELETE, .control = false, .shift = false, .makebreak = true },      // 127	DEL	(Delete)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 128	Ç	(Majuscule C-cedilla )			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 129	ü	(letter "u" with umlaut or diaeresis ; "u-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 130	é	(letter "e" with acute accent or "e-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 131	â	(letter "a" with circumflex accent or "a-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 132	ä	(letter "a" with umlaut or diaeresis ; "a-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 133	à	(letter "a" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 134	å	(letter "a"  with a ring)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 135	ç	(Minuscule c-cedilla)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 136	ê	(letter "e" with circumflex accent or "e-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 137	ë	(letter "e" with umlaut or diaeresis ; "e-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 138	è	(letter "e" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 139	ï	(letter "i" with umlaut or diaeresis ; "i-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 140	î	(letter "i" with circumflex accent or "i-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 141	ì	(letter "i" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 142	Ä	(letter "A" with umlaut or diaeresis ; "A-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 143	Å	(letter "A"  with a ring)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 144	É	(Capital letter "E" with acute accent or "E-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 145	æ	(Latin diphthong "ae")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 146	Æ	(Latin diphthong "AE")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 147	ô	(letter "o" with circumflex accent or "o-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 148	ö	(letter "o" with umlaut or diaeresis ; "o-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 149	ò	(letter "o" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 150	û	(letter "u" with circumflex accent or "u-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 151	ù	(letter "u" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 152	ÿ	(letter "y" with diaeresis)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 153	Ö	(letter "O" with umlaut or diaeresis ; "O-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 154	Ü	(letter "U" with umlaut or diaeresis ; "U-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 155	ø	(slashed zero or empty set)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 156	£	(Pound sign ; symbol for the pound sterling)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 157	Ø	(slashed zero or empty set)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 158	×	(multiplication sign)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 159	ƒ	(function sign ; f with hook sign ; florin sign )			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 160	á	(letter "a" with acute accent or "a-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 161	í	(letter "i" with acute accent or "i-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 162	ó	(letter "o" with acute accent or "o-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 163	ú	(letter "u" with acute accent or "u-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 164	ñ	(letter "n" with tilde ; enye)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 165	Ñ	(letter "N" with tilde ; enye)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 166	ª	(feminine ordinal indicator )			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 167	º	(masculine ordinal indicator)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 168	¿	(Inverted question marks)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 169	®	(Registered trademark symbol)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 170	¬	(Logical negation symbol)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 171	½	(One half)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 172	¼	(Quarter or  one fourth)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 173	¡	(Inverted exclamation marks)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 174	«	(Guillemets or  angle quotes)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 175	»	(Guillemets or  angle quotes)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 176	░				
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 177	▒				
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 178	▓				
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 179	│	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 180	┤	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 181	Á	(Capital letter "A" with acute accent or "A-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 182	Â	(letter "A" with circumflex accent or "A-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 183	À	(letter "A" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 184	©	(Copyright symbol)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 185	╣	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 186	║	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 187	╗	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 188	╝	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 189	¢	(Cent symbol)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 190	¥	(YEN and YUAN sign)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 191	┐	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 192	└	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 193	┴	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 194	┬	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 195	├	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 196	─	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 197	┼	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 198	ã	(letter "a" with tilde or "a-tilde")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 199	Ã	(letter "A" with tilde or "A-tilde")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 200	╚	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 201	╔	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 202	╩	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 203	╦	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 204	╠	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 205	═	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 206	╬	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 207	¤	(generic currency sign )			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 208	ð	(lowercase "eth")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 209	Ð	(Capital letter "Eth")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 210	Ê	(letter "E" with circumflex accent or "E-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 211	Ë	(letter "E" with umlaut or diaeresis ; "E-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 212	È	(letter "E" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 213	ı	(lowercase dot less i)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 214	Í	(Capital letter "I" with acute accent or "I-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 215	Î	(letter "I" with circumflex accent or "I-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 216	Ï	(letter "I" with umlaut or diaeresis ; "I-umlaut")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 217	┘	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 218	┌	(Box drawing character)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 219	█	(Block)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 220	▄				
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 221	¦	(vertical broken bar )			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 222	Ì	(letter "I" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 223	▀				
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 224	Ó	(Capital letter "O" with acute accent or "O-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 225	ß	(letter "Eszett" ; "scharfes S" or "sharp S")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 226	Ô	(letter "O" with circumflex accent or "O-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 227	Ò	(letter "O" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 228	õ	(letter "o" with tilde or "o-tilde")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 229	Õ	(letter "O" with tilde or "O-tilde")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 230	µ	(Lowercase letter "Mu" ; micro sign or micron)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 231	þ	(capital letter "Thorn")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 232	Þ	(lowercase letter "thorn")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 233	Ú	(Capital letter "U" with acute accent or "U-acute")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 234	Û	(letter "U" with circumflex accent or "U-circumflex")			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 235	Ù	(letter "U" with grave accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 236	ý	(letter "y" with acute accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 237	Ý	(Capital letter "Y" with acute accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 238	¯	(macron symbol)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 239	´	(Acute accent)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 240	¬	(Hyphen)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 241	±	(Plus-minus sign)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 242	‗	(underline or underscore)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 243	¾	(three quarters)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 244	¶	(paragraph sign or pilcrow)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 245	§	(Section sign)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 246	÷	(The division sign ; Obelus)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 247	¸	(cedilla)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 248	°	(degree symbol )			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 249	¨	(Diaeresis)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 250	•	(Interpunct or space dot)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 251	¹	(superscript one)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 252	³	(cube or superscript three)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 253	²	(Square or superscript two)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },    // 254	■	(black square)			
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true }     // 255	nbsp	(non-breaking space or no-break space)
     },
     { // Media Keymap -----------------------------------------------------------------------------------------------------------------------------------------
-        { .key = KEY_MUTE, .control = false, .shift = false, .makebreak = false },           // 0
-        { .key = KEY_VOLUMEUP, .control = false, .shift = false, .makebreak = false },       // 1
-        { .key = KEY_VOLUMEDOWN, .control = false, .shift = false, .makebreak = false },     // 2
-        { .key = KEY_PLAYPAUSE, .control = false, .shift = false, .makebreak = false },      // 3
-        { .key = KEY_NEXTSONG, .control = false, .shift = false, .makebreak = false },       // 4
-        { .key = KEY_PREVIOUSSONG, .control = false, .shift = false, .makebreak = false },   // 5
-        { .key = KEY_RECORD, .control = false, .shift = false, .makebreak = false },         // 6
-        { .key = KEY_REWIND, .control = false, .shift = false, .makebreak = false },         // 7
-        { .key = KEY_FORWARD, .control = false, .shift = false, .makebreak = false },        // 8
-        { .key = KEY_PLAYCD, .control = false, .shift = false, .makebreak = false },         // 9
-        { .key = KEY_PAUSECD, .control = false, .shift = false, .makebreak = false },        // 10
-        { .key = KEY_STOPCD, .control = false, .shift = false, .makebreak = false },         // 11
-        { .key = KEY_EJECTCD, .control = false, .shift = false, .makebreak = false },        // 12
-        { .key = KEY_CLOSECD, .control = false, .shift = false, .makebreak = false },        // 13
-        { .key = KEY_EJECTCLOSECD, .control = false, .shift = false, .makebreak = false },   // 14
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 15
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 16
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 17
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 18
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 19
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 20
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 21
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 22
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 23
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 24
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 25
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 26
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 27
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 28
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 29
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 30
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 31
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 32
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 33
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 34
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 35
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 36
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 37
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 38
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 39
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 40
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 41
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 42
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 43
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 44
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 45
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 46
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 47
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 48
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 49
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 50
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 51
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 52
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 53
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 54
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 55
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 56
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 57
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 58
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 59
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 60
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 61
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 62
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 63
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 64
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 65
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 66
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 67
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 68
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 69
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 70
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 71
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 72
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 73
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 74
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 75
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 76
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 77
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 78
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 79
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 80
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 81
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 82
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 83
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 84
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 85
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 86
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 87
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 88
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 89
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 90
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 91
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 92
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 93
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 94
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 95
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 96
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 97
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 98
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 99
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 100
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 101
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 102
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 103
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 104
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 105
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 106
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 107
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 108
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 109
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 110
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 111
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 112
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 113
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 114
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 115
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 116
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 117
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 118
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 119
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 120
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 121
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 122
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 123
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 124
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 125
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 126
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 127
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 128
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 129
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 130
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 131
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 132
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 133
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 134
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 135
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 136
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 137
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 138
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 139
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 140
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 141
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 142
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 143
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 144
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 145
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 146
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 147
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 148
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 149
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 150
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 151
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 152
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 153
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 154
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 155
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 156
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 157
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 158
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 159
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 160
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 161
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 162
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 163
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 164
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 165
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 166
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 167
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 168
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 169
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 170
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 171
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 172
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 173
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 174
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 175
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 176
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 177
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 178
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 179
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 180
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 181
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 182
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 183
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 184
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 185
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 186
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 187
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 188
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 189
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 190
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 191
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 192
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 193
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 194
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 195
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 196
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 197
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 198
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 199
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 200
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 201
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 202
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 203
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 204
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 205
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 206
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 207
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 208
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 209
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 210
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 211
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 212
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 213
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 214
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 215
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 216
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 217
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 218
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 219
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 220
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 221
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 222
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 223
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 224
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 225
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 226
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 227
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 228
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 229
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 230
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 231
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 232
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 233
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 234
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 235
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 236
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 237
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 238
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 239
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 240
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 241
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 242
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 243
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 244
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 245
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 246
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 247
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 248
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 249
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 250
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 251
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 252
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 253
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 254
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false }        // 255
+        { .key = KEY_MUTE, .control = false, .shift = false, .makebreak = true },            // 0
+        { .key = KEY_VOLUMEUP, .control = false, .shift = false, .makebreak = true },        // 1
+        { .key = KEY_VOLUMEDOWN, .control = false, .shift = false, .makebreak = true },      // 2
+        { .key = KEY_PLAYPAUSE, .control = false, .shift = false, .makebreak = true },       // 3
+        { .key = KEY_NEXTSONG, .control = false, .shift = false, .makebreak = true },        // 4
+        { .key = KEY_PREVIOUSSONG, .control = false, .shift = false, .makebreak = true },    // 5
+        { .key = KEY_RECORD, .control = false, .shift = false, .makebreak = true },          // 6
+        { .key = KEY_REWIND, .control = false, .shift = false, .makebreak = true },          // 7
+        { .key = KEY_FORWARD, .control = false, .shift = false, .makebreak = true },         // 8
+        { .key = KEY_PLAYCD, .control = false, .shift = false, .makebreak = true },          // 9
+        { .key = KEY_PAUSECD, .control = false, .shift = false, .makebreak = true },         // 10
+        { .key = KEY_STOPCD, .control = false, .shift = false, .makebreak = true },          // 11
+        { .key = KEY_EJECTCD, .control = false, .shift = false, .makebreak = true },         // 12
+        { .key = KEY_CLOSECD, .control = false, .shift = false, .makebreak = true },         // 13
+        { .key = KEY_EJECTCLOSECD, .control = false, .shift = false, .makebreak = true },    // 14
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 15
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 16
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 17
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 18
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 19
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 20
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 21
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 22
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 23
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 24
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 25
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 26
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 27
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 28
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 29
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 30
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 31
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 32
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 33
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 34
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 35
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 36
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 37
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 38
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 39
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 40
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 41
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 42
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 43
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 44
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 45
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 46
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 47
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 48
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 49
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 50
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 51
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 52
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 53
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 54
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 55
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 56
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 57
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 58
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 59
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 60
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 61
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 62
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 63
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 64
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 65
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 66
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 67
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 68
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 69
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 70
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 71
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 72
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 73
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 74
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 75
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 76
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 77
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 78
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 79
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 80
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 81
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 82
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 83
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 84
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 85
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 86
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 87
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 88
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 89
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 90
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 91
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 92
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 93
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 94
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 95
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 96
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 97
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 98
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 99
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 100
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 101
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 102
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 103
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 104
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 105
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 106
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 107
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 108
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 109
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 110
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 111
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 112
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 113
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 114
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 115
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 116
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 117
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 118
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 119
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 120
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 121
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 122
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 123
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 124
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 125
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 126
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 127
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 128
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 129
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 130
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 131
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 132
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 133
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 134
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 135
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 136
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 137
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 138
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 139
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 140
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 141
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 142
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 143
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 144
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 145
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 146
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 147
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 148
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 149
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 150
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 151
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 152
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 153
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 154
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 155
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 156
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 157
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 158
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 159
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 160
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 161
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 162
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 163
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 164
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 165
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 166
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 167
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 168
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 169
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 170
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 171
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 172
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 173
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 174
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 175
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 176
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 177
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 178
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 179
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 180
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 181
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 182
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 183
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 184
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 185
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 186
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 187
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 188
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 189
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 190
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 191
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 192
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 193
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 194
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 195
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 196
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 197
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 198
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 199
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 200
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 201
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 202
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 203
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 204
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 205
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 206
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 207
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 208
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 209
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 210
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 211
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 212
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 213
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 214
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 215
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 216
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 217
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 218
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 219
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 220
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 221
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 222
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 223
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 224
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 225
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 226
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 227
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 228
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 229
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 230
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 231
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 232
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 233
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 234
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 235
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 236
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 237
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 238
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 239
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 240
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 241
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 242
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 243
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 244
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 245
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 246
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 247
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 248
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 249
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 250
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 251
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 252
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 253
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 254
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true }         // 255
    },
     { // Custom Keymap ---------------------------------------------------------------------------------------------------------------------------------------
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 0
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 1
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 2
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 3
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 4
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 5
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 6
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 7
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 8
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 9
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 10
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 11
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 12
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 13
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 14
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 15
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 16
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 17
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 18
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 19
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 20
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 21
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 22
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 23
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 24
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 25
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 26
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 27
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 28
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 29
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 30
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 31
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 32
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 33
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 34
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 35
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 36
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 37
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 38
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 39
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 40
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 41
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 42
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 43
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 44
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 45
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 46
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 47
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 48
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 49
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 50
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 51
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 52
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 53
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 54
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 55
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 56
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 57
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 58
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 59
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 60
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 61
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 62
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 63
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 64
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 65
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 66
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 67
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 68
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 69
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 70
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 71
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 72
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 73
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 74
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 75
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 76
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 77
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 78
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 79
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 80
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 81
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 82
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 83
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 84
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 85
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 86
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 87
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 88
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 89
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 90
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 91
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 92
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 93
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 94
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 95
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 96
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 97
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 98
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 99
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 100
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 101
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 102
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 103
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 104
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 105
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 106
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 107
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 108
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 109
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 110
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 111
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 112
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 113
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 114
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 115
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 116
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 117
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 118
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 119
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 120
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 121
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 122
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 123
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 124
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 125
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 126
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 127
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 128
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 129
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 130
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 131
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 132
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 133
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 134
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 135
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 136
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 137
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 138
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 139
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 140
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 141
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 142
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 143
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 144
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 145
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 146
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 147
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 148
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 149
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 150
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 151
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 152
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 153
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 154
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 155
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 156
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 157
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 158
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 159
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 160
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 161
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 162
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 163
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 164
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 165
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 166
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 167
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 168
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 169
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 170
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 171
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 172
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 173
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 174
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 175
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 176
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 177
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 178
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 179
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 180
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 181
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 182
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 183
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 184
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 185
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 186
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 187
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 188
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 189
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 190
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 191
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 192
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 193
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 194
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 195
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 196
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 197
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 198
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 199
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 200
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 201
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 202
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 203
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 204
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 205
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 206
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 207
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 208
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 209
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 210
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 211
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 212
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 213
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 214
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 215
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 216
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 217
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 218
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 219
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 220
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 221
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 222
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 223
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 224
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 225
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 226
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 227
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 228
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 229
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 230
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 231
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 232
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 233
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 234
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 235
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 236
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 237
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 238
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 239
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 240
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 241
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 242
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 243
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 244
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 245
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 246
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 247
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 248
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 249
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 250
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 251
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 252
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 253
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false },       // 254
-        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = false }        // 255
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 0
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 1
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 2
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 3
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 4
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 5
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 6
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 7
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 8
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 9
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 10
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 11
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 12
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 13
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 14
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 15
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 16
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 17
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 18
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 19
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 20
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 21
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 22
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 23
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 24
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 25
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 26
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 27
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 28
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 29
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 30
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 31
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 32
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 33
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 34
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 35
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 36
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 37
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 38
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 39
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 40
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 41
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 42
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 43
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 44
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 45
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 46
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 47
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 48
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 49
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 50
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 51
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 52
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 53
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 54
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 55
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 56
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 57
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 58
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 59
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 60
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 61
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 62
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 63
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 64
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 65
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 66
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 67
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 68
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 69
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 70
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 71
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 72
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 73
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 74
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 75
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 76
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 77
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 78
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 79
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 80
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 81
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 82
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 83
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 84
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 85
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 86
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 87
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 88
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 89
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 90
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 91
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 92
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 93
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 94
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 95
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 96
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 97
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 98
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 99
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 100
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 101
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 102
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 103
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 104
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 105
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 106
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 107
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 108
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 109
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 110
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 111
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 112
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 113
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 114
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 115
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 116
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 117
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 118
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 119
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 120
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 121
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 122
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 123
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 124
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 125
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 126
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 127
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 128
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 129
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 130
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 131
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 132
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 133
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 134
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 135
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 136
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 137
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 138
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 139
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 140
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 141
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 142
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 143
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 144
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 145
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 146
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 147
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 148
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 149
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 150
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 151
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 152
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 153
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 154
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 155
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 156
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 157
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 158
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 159
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 160
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 161
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 162
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 163
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 164
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 165
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 166
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 167
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 168
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 169
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 170
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 171
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 172
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 173
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 174
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 175
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 176
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 177
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 178
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 179
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 180
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 181
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 182
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 183
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 184
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 185
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 186
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 187
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 188
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 189
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 190
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 191
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 192
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 193
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 194
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 195
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 196
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 197
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 198
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 199
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 200
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 201
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 202
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 203
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 204
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 205
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 206
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 207
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 208
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 209
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 210
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 211
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 212
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 213
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 214
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 215
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 216
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 217
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 218
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 219
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 220
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 221
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 222
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 223
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 224
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 225
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 226
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 227
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 228
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 229
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 230
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 231
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 232
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 233
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 234
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 235
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 236
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 237
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 238
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 239
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 240
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 241
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 242
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 243
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 244
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 245
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 246
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 247
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 248
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 249
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 250
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 251
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 252
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 253
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true },        // 254
+        { .key = KEY_RESERVED, .control = false, .shift = false, .makebreak = true }         // 255
    }
 };
\ No newline at end of file
@@ -0,0 +1,347 @@
+/*
+ * serkey unit tests
+ *
+ * Built and run by make test. Includes serkey.c to reach its local
+ * functions, and checks the key maps, the single make/break entries, the
+ * +make and +break remap rules with autorepeat, random byte streams through
+ * the whole key path, and the data bits option against the mock output
+ * --check_keymap writes to. Each test starts from the default state.
+ * Exits with the number of failed checks.
+ */
+#define main serkeyMain
+int serkeyMain(int argc, char *argv[]);
+#include "serkey.c"
+#undef main
+
+#define TEST_SEED          0x5e12c0deU  // Seed of the random byte streams, fixed so failures repeat
+#define TEST_READS         2000         // Random reads sent through each key map
+
+local config_t    defaultConfig;       // appConfig before any test changed it
+local uint32_t    testRandom;          // State of the random byte generator
+
+// Local function prototypes **************************************************
+local void resetState(void);
+
+local uint32_t nextRandom(void);
+
+local bool isHeld(int code);                // Key code
+
+local int testSingleEvents(FILE *output);   // Stream to display the results
+
+local int testRandomStreams(FILE *output);  // Stream to display the results
+
+local int testRemapSingle(FILE *output);    // Stream to display the results
+
+local int testDataBits(FILE *output);       // Stream to display the results
+
+/*
+ * Run the tests
+ */
+int main(void)
+{
+   int failed = 0;
+
+   // Save the defaults each test starts from, and give the keypads their
+   // byte counts as main() does
+   defaultConfig = appConfig;
+   for(int i=0;i<=BUS_DEVICES;++i)
+      devices[i].keyCounts = keyCountBuffer[i];
+
+   // Every built-in map must balance its makes, breaks, and modifiers
+   resetState();
+   if(checkKeymaps(stdout))
+      ++failed;
+
+   failed += testSingleEvents(stdout);
+   failed += testRandomStreams(stdout);
+   failed += testRemapSingle(stdout);
+   failed += testDataBits(stdout);
+
+   printf("Tests: %s (%d failed)\n", failed?"FAIL":"OK", failed);
+   return(failed);
+}
+
+/*
+ * Restore the configuration, key map, autorepeat, held keys, and recorded
+ * events, so no test depends on the ones run before it
+ */
+local void resetState(void)
+{
+   appConfig = defaultConfig;
+   compileKeymap(NULL);
+   repeat = (repeat_t){.key = KEY_RESERVED};
+   memset(heldKeys, 0, sizeof(heldKeys));
+   memset(checkPressed, 0, sizeof(checkPressed));
+   checkEvents = 0;
+   writeEvents = writeCheck;
+}
+
+/*
+ * Return the next number of a xorshift generator
+ */
+local uint32_t nextRandom(void)
+{
+   testRandom ^= testRandom << 13;
+   testRandom ^= testRandom >> 17;
+   testRandom ^= testRandom << 5;
+   return(testRandom);
+}
+
+/*
+ * Returns true if the key is made as far as the key path knows
+ */
+local bool isHeld(int code)
+{
+   return(heldKeys[code / 8] & (1 << (code % 8)));
+}
+
+/*
+ * Check single make and break entries, including key codes over 127 that
+ * don't fit in a byte
+ */
+local int testSingleEvents(FILE *output)
+{
+   keymap_t map[KEYS_PER_MAP] = {{.key = KEY_RESERVED}};
+   int      failed = 0;
+
+   resetState();
+
+   // A make and a break of KEY_PLAYPAUSE balance
+   map[0] = (keymap_t){.key = KEY_PLAYPAUSE, .make = true};
+   map[1] = (keymap_t){.key = KEY_PLAYPAUSE, .make = false};
+   if(checkKeymap(map, "single", output))
+      ++failed;
+
+   // The make must press KEY_PLAYPAUSE, not a key sharing its low bits
+   memset(checkPressed, 0, sizeof(checkPressed));
+   emitKey(-1, &map[0]);
+   flushFrame(-1);
+   if(checkPressed[KEY_PLAYPAUSE] != 1 || checkPressed[KEY_PLAYPAUSE & 0x7f] != 0)
+   {
+      fprintf(output, "single: make of key %d pressed the wrong key\n", KEY_PLAYPAUSE);
+      ++failed;
+   }
+
+   // A make without a break must be reported
+   map[1] = (keymap_t){.key = KEY_RESERVED};
+   if(!checkKeymap(map, "unbalanced (expected)", output))
+   {
+      fprintf(output, "unbalanced: a make without a break passed\n");
+      ++failed;
+   }
+
+   return(failed);
+}
+
+/*
+ * Send random reads of random bytes through the key path, as the serial
+ * port would. With every built-in key map each read must leave no key or
+ * modifier pressed. With single make and break rules, the keys the path
+ * holds must follow the last event of each, and releasing them at exit
+ * must break exactly those
+ */
+local int testRandomStreams(FILE *output)
+{
+   const int      singles[] = {KEY_A, KEY_B, KEY_LEFTSHIFT};
+   unsigned char  keys[SERIAL_READ_SIZE];
+   int            failed = 0, before[KEY_CNT];
+   bool           model[KEY_CNT];
+
+   testRandom = TEST_SEED;
+
+   // For each built-in key map...
+   for(int map=0;map<KEYMAPS;++map)
+   {
+      resetState();
+      appConfig.keymap = (keymaps_t)map;
+      compileKeymap(NULL);
+
+      for(int read=0;read<TEST_READS;++read)
+      {
+         ssize_t count = 1 + (ssize_t)(nextRandom() % SERIAL_READ_SIZE);
+         int     code;
+
+         for(ssize_t i=0;i<count;++i)
+            keys[i] = (unsigned char)nextRandom();
+         processKeys(keys, count, monotonicTime(), -1);
+
+         // Every make must have been broken by the end of the read
+         for(code=0;code<KEY_CNT;++code)
+            if(checkPressed[code] || isHeld(code))
+               break;
+         if(code < KEY_CNT)
+         {
+            fprintf(output, "random %s: read %d left key %d pressed\n", keymapName(map), read, code);
+            ++failed;
+            break;
+         }
+      }
+   }
+
+   // Single make and break rules, mixed with make/break bytes
+   resetState();
+   compileKeymap("0x61=KEY_A+make,0x62=KEY_A+break,0x63=KEY_B+make,0x64=KEY_B+break,"
+                 "0x65=KEY_LEFTSHIFT+make,0x66=KEY_LEFTSHIFT+break");
+   memset(model, 0, sizeof(model));
+   for(int read=0;read<TEST_READS && !failed;++read)
+   {
+      ssize_t count = 1 + (ssize_t)(nextRandom() % 8);
+
+      for(ssize_t i=0;i<count;++i)
+      {
+         keys[i] = (unsigned char)(0x60 + nextRandom() % 8);
+         if(!activeMap[keys[i]].makebreak)
+            model[activeMap[keys[i]].key] = activeMap[keys[i]].make;
+      }
+      processKeys(keys, count, monotonicTime(), -1);
+
+      for(size_t i=0;i<sizeof(singles)/sizeof(singles[0]);++i)
+         if(isHeld(singles[i]) != model[singles[i]])
+         {
+            fprintf(output, "random single: read %d key %d held %d, last event %d\n",
+                    read, singles[i], isHeld(singles[i]), model[singles[i]]);
+            ++failed;
+         }
+   }
+
+   // Releasing at exit must break the held keys and nothing else
+   memcpy(before, checkPressed, sizeof(before));
+   releaseKeys(-1);
+   flushFrame(-1);
+   for(int code=0;code<KEY_CNT;++code)
+      if(isHeld(code) || checkPressed[code] != before[code] - (model[code]?1:0))
+      {
+         fprintf(output, "random single: key %d not released correctly\n", code);
+         ++failed;
+      }
+
+   fprintf(output, "Random streams: %s (%d problems, seed 0x%08x)\n", failed?"FAIL":"OK", failed, TEST_SEED);
+   return(failed);
+}
+
+/*
+ * Check the +make and +break remap rules map a byte to a single event, and
+ * that autorepeat repeats the key made until its break
+ */
+local int testRemapSingle(FILE *output)
+{
+   const char  *invalid[] = {"0x61=KEY_A+make+break", "0x61=KEY_A+break+break", "0x61=KEY_A+mak"};
+   char        *error = NULL;
+   int         failed = 0;
+
+   resetState();
+
+   // The rules must set the byte to just a make or just a break
+   if(!compileKeymap("0x61=KEY_A+make,0x62=KEY_A+break,0x63=KEY_B") ||
+      activeMap[0x61].key != KEY_A || activeMap[0x61].makebreak || !activeMap[0x61].make ||
+      activeMap[0x62].key != KEY_A || activeMap[0x62].makebreak || activeMap[0x62].make ||
+      !activeMap[0x63].makebreak)
+   {
+      fprintf(output, "remap: +make and +break not applied\n");
+      ++failed;
+   }
+   if(checkKeymap(activeMap, "remap +make/+break", output))
+      ++failed;
+
+   // Only one of them, once, is accepted
+   for(size_t i=0;i<sizeof(invalid)/sizeof(invalid[0]);++i)
+      if(compileKeymap(invalid[i]))
+      {
+         fprintf(output, "remap: %s accepted\n", invalid[i]);
+         ++failed;
+      }
+
+   // With -A, the make starts the repeat and the break stops it. A make and
+   // break together never repeats
+   compileKeymap("0x61=KEY_A+make,0x62=KEY_A+break,0x63=KEY_B");
+   if(applyOption(findOption('A'), "500", &error))
+   {
+      fprintf(output, "-A 500: %s\n", error);
+      ++failed;
+   }
+   emitKey(-1, &activeMap[0x61]);
+   flushFrame(-1);
+   if(repeat.key != KEY_A)
+   {
+      fprintf(output, "autorepeat: +make didn't start the repeat\n");
+      ++failed;
+   }
+   emitKey(-1, &activeMap[0x62]);
+   flushFrame(-1);
+   if(repeat.key != KEY_RESERVED)
+   {
+      fprintf(output, "autorepeat: +break didn't stop the repeat\n");
+      ++failed;
+   }
+   emitKey(-1, &activeMap[0x63]);
+   flushFrame(-1);
+   if(repeat.key != KEY_RESERVED)
+   {
+      fprintf(output, "autorepeat: a make and break repeats\n");
+      ++failed;
+   }
+
+   // A rate of 0 is rejected, even with autorepeat off
+   if(applyOption(findOption('A'), "0,0", &error) == 0 || applyOption(findOption('A'), "500,0", &error) == 0)
+   {
+      fprintf(output, "-A 0,0: accepted\n");
+      ++failed;
+   }
+
+   fprintf(output, "Remap +make/+break: %s (%d problems)\n", failed?"FAIL":"OK", failed);
+   return(failed);
+}
+
+/*
+ * Check the data bits option accepts 5 to 8 from the command line and the
+ * configuration file, and rejects anything else
+ */
+local int testDataBits(FILE *output)
+{
+   const struct
+   {
+      char        *value;
+      bool        valid;
+      databits_t  databits;
+   }  tests[] =
+   {
+      {.value = "5", .valid = true, .databits = DATABITS_5},
+      {.value = "6", .valid = true, .databits = DATABITS_6},
+      {.value = "7", .valid = true, .databits = DATABITS_7},
+      {.value = "8", .valid = true, .databits = DATABITS_8},
+      {.value = "4", .valid = false},
+      {.value = "9", .valid = false},
+      {.value = "x", .valid = false}
+   };
+   int      failed = 0;
+
+   resetState();
+   for(size_t i=0;i<sizeof(tests)/sizeof(tests[0]);++i)
+   {
+      char  *error = NULL, text[32];
+      int   line = 0, ret;
+
+      // From the command line...
+      appConfig.databits = DATABITS_8;
+      ret = applyOption(findOption('d'), tests[i].value, &error);
+      if((ret == 0) != tests[i].valid || (tests[i].valid && appConfig.databits != tests[i].databits))
+      {
+         fprintf(output, "-d %s: %s\n", tests[i].value, ret?error:"wrong data bits");
+         ++failed;
+      }
+
+      // From the configuration file...
+      appConfig.databits = DATABITS_8;
+      snprintf(text, sizeof(text), "data_bits = %s\n", tests[i].value);
+      ret = parseConfig(text, strlen(text), &line, &error);
+      if((ret == 0) != tests[i].valid || (tests[i].valid && appConfig.databits != tests[i].databits))
+      {
+         fprintf(output, "data_bits = %s: %s\n", tests[i].value, ret?error:"wrong data bits");
+         ++failed;
+      }
+   }
+   appConfig.databits = defaultConfig.databits;
+
+   fprintf(output, "Data bits: %s (%d problems)\n", failed?"FAIL":"OK", failed);
+   return(failed);
+}